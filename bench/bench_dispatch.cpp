@@ -0,0 +1,75 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+#include "memory_node.h"
+#include "object.h"
+#include "ops.h"
+
+// Type checks over a mix of heap objects and immediates, the shape they
+// have when a call is dispatched and its arguments are checked.
+
+static std::vector<Object*> MakeMixedObjects(Cleaner* cleaner) {
+    std::vector<Object*> objects;
+    for (int i = 0; i < 1024; ++i) {
+        switch (i % 6) {
+            case 0:
+                objects.push_back(cleaner->Intern("x"));
+                break;
+            case 1:
+                objects.push_back(cleaner->Make<Cell>(nullptr, nullptr));
+                break;
+            case 2:
+                objects.push_back(cleaner->Make<OpHolder<Add>>());
+                break;
+            case 3:
+                objects.push_back(cleaner->Make<OpHolder<Sub>>());
+                break;
+            case 4:
+                objects.push_back(MakeNumber(i));
+                break;
+            default:
+                objects.push_back(ConstructBool(i % 2 == 0));
+        }
+    }
+    return objects;
+}
+
+// The dynamic_cast based checks Is and As used before type tags.
+template <class T>
+static bool IsByRtti(Object* obj) {
+    return obj != nullptr && !IsImmediate(obj) && dynamic_cast<T*>(obj) != nullptr;
+}
+
+static void BM_RttiDispatch(benchmark::State& state) {
+    Cleaner cleaner;
+    auto objects = MakeMixedObjects(&cleaner);
+    for (auto _ : state) {
+        size_t matches = 0;
+        for (Object* obj : objects) {
+            matches += IsByRtti<Cell>(obj);
+            matches += IsByRtti<Symbol>(obj);
+            matches += IsByRtti<BaseOpHolder>(obj);
+            matches += IsByRtti<OpHolder<Sub>>(obj);
+        }
+        benchmark::DoNotOptimize(matches);
+    }
+    state.SetItemsProcessed(state.iterations() * objects.size() * 4);
+}
+BENCHMARK(BM_RttiDispatch);
+
+static void BM_TagDispatch(benchmark::State& state) {
+    Cleaner cleaner;
+    auto objects = MakeMixedObjects(&cleaner);
+    for (auto _ : state) {
+        size_t matches = 0;
+        for (Object* obj : objects) {
+            matches += Is<Cell>(obj);
+            matches += Is<Symbol>(obj);
+            matches += Is<BaseOpHolder>(obj);
+            matches += Is<OpHolder<Sub>>(obj);
+        }
+        benchmark::DoNotOptimize(matches);
+    }
+    state.SetItemsProcessed(state.iterations() * objects.size() * 4);
+}
+BENCHMARK(BM_TagDispatch);
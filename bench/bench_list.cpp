@@ -0,0 +1,34 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include "scheme.h"
+
+// Walks over lists built by Scheme code, the way list procedures written
+// in Scheme use cdr and list-tail.
+
+static void DefineList(Interpreter* interpreter, int64_t size) {
+    interpreter->Run("(define (build n acc) (if (= n 0) acc (build (- n 1) (cons n acc))))");
+    interpreter->Run("(define lst (build " + std::to_string(size) + " '()))");
+}
+
+static void BM_WalkWithCdr(benchmark::State& state) {
+    Interpreter interpreter;
+    DefineList(&interpreter, state.range(0));
+    interpreter.Run("(define (len l acc) (if (null? l) acc (len (cdr l) (+ acc 1))))");
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(interpreter.Run("(len lst 0)"));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_WalkWithCdr)->Arg(1'000)->Arg(10'000)->Arg(100'000);
+
+static void BM_ListTail(benchmark::State& state) {
+    Interpreter interpreter;
+    DefineList(&interpreter, state.range(0));
+    std::string expression = "(list-tail lst " + std::to_string(state.range(0) - 1) + ")";
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(interpreter.Run(expression));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ListTail)->Arg(1'000)->Arg(10'000)->Arg(100'000);
@@ -0,0 +1,81 @@
+#include <benchmark/benchmark.h>
+
+#include <sstream>
+#include <string>
+#include "tokenizer.h"
+
+// Tokenizes about 1 MB of typical source: definitions with nested calls,
+// numbers, quoted lists and indentation.
+
+static std::string MakeSource() {
+    std::string source;
+    for (int i = 0; source.size() < (1 << 20); ++i) {
+        std::string n = std::to_string(i);
+        source += "(define (fib-" + n + " n)\n";
+        source += "    (if (< n 2)\n";
+        source += "        n\n";
+        source += "        (+ (fib-" + n + " (- n 1)) (fib-" + n + " (- n " + n + ")))))\n";
+        source += "(define table-" + n + " '(1 -2 #t #f (a . b) symbol-with-long-name?))\n";
+    }
+    return source;
+}
+
+// About 1 MB of quoted data: rows of small numbers and symbols.
+static std::string MakeData() {
+    std::string source = "'(";
+    for (int i = 0; source.size() < (1 << 20); ++i) {
+        source += "\n  (row-" + std::to_string(i) + " " + std::to_string(i % 97) + " " +
+                  std::to_string(i * 7 % 1000) + " #t (x . y))";
+    }
+    return source + ")\n";
+}
+
+static void TokenizeView(benchmark::State& state, const std::string& source) {
+    for (auto _ : state) {
+        size_t count = 0;
+        for (Tokenizer tokenizer{std::string_view(source)}; !tokenizer.IsEnd(); tokenizer.Next()) {
+            ++count;
+        }
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetBytesProcessed(state.iterations() * source.size());
+}
+
+static void BM_TokenizeData(benchmark::State& state) {
+    TokenizeView(state, MakeData());
+}
+BENCHMARK(BM_TokenizeData);
+
+// About 1 MB of deeply indented source with long names.
+static std::string MakeLongRuns() {
+    std::string source;
+    for (int i = 0; source.size() < (1 << 20); ++i) {
+        source += "\n" + std::string(40, ' ') + "(define-record-field-accessor-" +
+                  std::to_string(i) + " record-with-a-descriptive-name)";
+    }
+    return source;
+}
+
+static void BM_TokenizeLongRuns(benchmark::State& state) {
+    TokenizeView(state, MakeLongRuns());
+}
+BENCHMARK(BM_TokenizeLongRuns);
+
+static void BM_TokenizeView(benchmark::State& state) {
+    TokenizeView(state, MakeSource());
+}
+BENCHMARK(BM_TokenizeView);
+
+static void BM_TokenizeStream(benchmark::State& state) {
+    std::string source = MakeSource();
+    for (auto _ : state) {
+        std::stringstream stream(source);
+        size_t count = 0;
+        for (Tokenizer tokenizer{&stream}; !tokenizer.IsEnd(); tokenizer.Next()) {
+            ++count;
+        }
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetBytesProcessed(state.iterations() * source.size());
+}
+BENCHMARK(BM_TokenizeStream);
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Size-class slab allocator for heap nodes.
+//
+// Memory is taken from the system in aligned pages of kPageSize bytes.
+// Every page serves a single slot size, so the page of any slot is found
+// by masking its address. Freed slots go to a per-size-class free list
+// and are reused before fresh slots are carved from the newest page.
+// Each page keeps a bitmap of live slots which lets the collector walk
+// all allocated objects linearly.
+class SlabAllocator {
+public:
+    static constexpr size_t kPageSize = 1 << 16;
+    static constexpr size_t kSlotAlignment = 16;
+    static constexpr size_t kMaxSlotSize = 256;
+
+    SlabAllocator() = default;
+    ~SlabAllocator();
+
+    SlabAllocator(const SlabAllocator&) = delete;
+    SlabAllocator& operator=(const SlabAllocator&) = delete;
+
+    void* Allocate(size_t size);
+    void Free(void* slot);
+    // Returns every page to the system. All slots must be dead already.
+    void Release();
+
+    size_t LiveCount() const;
+
+    // Calls func(slot) for every allocated slot. func may free the slot
+    // it is given.
+    template <typename F>
+    void ForEachLive(F&& func) {
+        for (auto& size_class : size_classes_) {
+            for (Page* page : size_class.pages) {
+                for (size_t word = 0; word < kBitmapWords; ++word) {
+                    uint64_t bits = page->live[word];
+                    while (bits != 0) {
+                        size_t bit = static_cast<size_t>(__builtin_ctzll(bits));
+                        bits &= bits - 1;
+                        func(page->Slot(word * 64 + bit));
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    static constexpr size_t kSizeClassesCount = kMaxSlotSize / kSlotAlignment;
+    static constexpr size_t kBitmapWords = kPageSize / kSlotAlignment / 64;
+
+    struct FreeSlot {
+        FreeSlot* next;
+    };
+
+    struct Page {
+        size_t slot_size;
+        size_t slot_count;
+        size_t used_count;
+        uint64_t live[kBitmapWords];
+
+        static size_t FirstSlotOffset();
+        char* Slot(size_t index);
+        size_t IndexOf(void* slot);
+    };
+
+    struct SizeClass {
+        std::vector<Page*> pages;
+        FreeSlot* free_list = nullptr;
+    };
+
+    static Page* PageOf(void* slot);
+    Page* NewPage(size_t slot_size);
+
+    SizeClass size_classes_[kSizeClassesCount];
+    size_t live_count_ = 0;
+};
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "node.h"
+#include "object.h"
+
+// Turns a form returned by the parser into a node tree, to be compiled
+// and run in the global scope.
+//
+// Special forms are recognised by their keyword unless a local shadows
+// it. Each lambda gets a frame layout: its parameters followed by every
+// name its body defines outside of nested lambdas. References to those
+// names, from the body or from nested lambdas, become frame depth and
+// slot pairs; any other name is global and is looked up when it runs.
+// Malformed special forms raise SyntaxError here, before anything runs.
+Node* Analyze(Object* form, Cleaner* cleaner);
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "memory_node.h"
+#include "object.h"
+
+class LambdaNode;
+
+// Instructions are 32-bit words with the opcode in the low byte and an
+// operand in the other 24 bits. Stack effects are noted as
+// (inputs -- outputs).
+enum class Opcode : uint8_t {
+    CONST,                 // ( -- value) object constant #operand
+    LOCAL0,                // ( -- value) slot #operand of the current frame
+    LOCAL,                 // ( -- value) slot #operand; the next word is the frame depth
+    SET_LOCAL0,            // (value -- ())
+    SET_LOCAL,             // (value -- ()) the next word is the frame depth
+    GLOBAL,                // ( -- value) global named by object constant #operand
+    SET_GLOBAL,            // (value -- ()) the name must be defined already
+    DEFINE_GLOBAL,         // (value -- ())
+    CLOSURE,               // ( -- procedure) of lambda constant #operand
+    POP,                   // (value -- )
+    JUMP,                  // to instruction #operand
+    JUMP_IF_FALSE,         // (value -- )
+    JUMP_IF_FALSE_OR_POP,  // (value -- value) jumps on #f, otherwise pops
+    JUMP_IF_TRUE_OR_POP,   // (value -- value) jumps unless #f, otherwise pops
+    CALL,                  // (callee args... -- result) with #operand args
+    TAIL_CALL,             // (callee args... -- ) CALL in place of the current frame
+    RETURN,                // (result -- ) to the caller's frame
+
+    // Calls of builtins through their global name, object constant
+    // #operand. The common case is done in place; a rebound name or
+    // unusual arguments fall back to a regular call.
+    ADD, SUB, MUL,                                // (a b -- result)
+    NUM_EQ, LESS, GREATER, LESS_EQ, GREATER_EQ,   // (a b -- result)
+    CONS,                                         // (a b -- result)
+    CAR, CDR, IS_NULL, NOT,                       // (a -- result)
+};
+
+inline constexpr uint32_t kOperandBits = 24;
+inline constexpr uint32_t kMaxOperand = (1u << kOperandBits) - 1;
+
+inline uint32_t Encode(Opcode op, uint32_t operand) {
+    return static_cast<uint32_t>(op) | (operand << 8);
+}
+
+inline Opcode DecodeOpcode(uint32_t word) {
+    return static_cast<Opcode>(word & 0xff);
+}
+
+inline uint32_t DecodeOperand(uint32_t word) {
+    return word >> 8;
+}
+
+// Compiled code of a lambda body or of a top-level form, see compiler.h.
+class Code : public MemoryNode {
+public:
+    Code(std::vector<uint32_t> instructions, std::vector<Object*> objects,
+         std::vector<LambdaNode*> lambdas);
+
+    const uint32_t* Instructions() const {
+        return instructions_.data();
+    }
+    Object* GetObject(uint32_t index) const {
+        return objects_[index];
+    }
+    LambdaNode* GetLambda(uint32_t index) const {
+        return lambdas_[index];
+    }
+
+    // Inline cache of the instruction naming a global by object constant
+    // #index: the binding it resolved to, or nullptr before the first run.
+    Object** GetCachedBinding(uint32_t index) const {
+        return bindings_[index];
+    }
+    void CacheBinding(uint32_t index, Object** binding) {
+        bindings_[index] = binding;
+    }
+
+protected:
+    void Trace(Cleaner* cleaner) override;
+
+private:
+    std::vector<uint32_t> instructions_;
+    std::vector<Object*> objects_;
+    std::vector<LambdaNode*> lambdas_;
+    std::vector<Object**> bindings_;
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "bytecode.h"
+#include "memory_node.h"
+#include "object.h"
+
+class Node;
+class LambdaNode;
+
+// Builds one Code object. Nodes emit themselves through Node::Compile.
+class Compiler {
+public:
+    explicit Compiler(Cleaner* cleaner);
+
+    void Emit(Opcode op, uint32_t operand = 0);
+    // A raw word following the previous instruction.
+    void EmitWord(uint32_t word);
+    // Emits a jump and returns its position for PatchJump.
+    size_t EmitJump(Opcode op);
+    // Makes the jump emitted at position jump go to the next instruction.
+    void PatchJump(size_t jump);
+
+    uint32_t AddObject(Object* obj);
+    uint32_t AddLambda(LambdaNode* lambda);
+
+    Code* Finish();
+
+private:
+    Cleaner* cleaner_;
+    std::vector<uint32_t> instructions_;
+    std::vector<Object*> objects_;
+    std::vector<LambdaNode*> lambdas_;
+};
+
+// Code of a top-level form, run in the global scope.
+Code* CompileTopLevel(Node* node, Cleaner* cleaner);
+
+// Code of a lambda body, run in a frame of its own.
+Code* CompileBody(const std::vector<Node*>& body, Cleaner* cleaner);
+
+// Opcode for a call of the builtin bound to name with argc arguments, if
+// there is one. Sets *op and returns true then.
+bool FindBuiltinOpcode(Symbol* name, size_t argc, Opcode* op);
@@ -6,6 +6,12 @@ struct SyntaxError : public std::runtime_error {
     using std::runtime_error::runtime_error;
 };
 
+// A syntax error in the text of a form rather than in its structure. The
+// input after it cannot be split into forms.
+struct ReadError : public SyntaxError {
+    using SyntaxError::SyntaxError;
+};
+
 struct RuntimeError : public std::runtime_error {
     using std::runtime_error::runtime_error;
 };
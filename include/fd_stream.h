@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <streambuf>
+#include <vector>
+
+// Input stream buffer over a file descriptor. Each underflow makes one read
+// of at most the chunk size, so pipes and terminals give data as soon as it
+// arrives and memory does not grow with the input. The descriptor is left
+// open.
+class FdStreamBuf : public std::streambuf {
+public:
+    static constexpr size_t kDefaultChunkSize = 1 << 16;
+
+    explicit FdStreamBuf(int fd, size_t chunk_size = kDefaultChunkSize);
+
+protected:
+    int_type underflow() override;
+
+private:
+    int fd_;
+    std::vector<char> chunk_;
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "memory_node.h"
+#include "object.h"
+
+// Hash table object with open addressing and linear probing.
+//
+// Keys are compared with equal? semantics: numbers, booleans and interned
+// symbols by value, lists structurally (circular ones included), anything
+// else by identity. A list key must not be mutated while it is in the table. Slots live in one
+// contiguous array that doubles once it is three quarters full; deletion
+// shifts the following entries back instead of leaving tombstones.
+class HashTable : public Object {
+public:
+    static bool ClassOf(const Object* obj) {
+        return obj->GetType() == ObjectType::HASH_TABLE;
+    }
+
+    HashTable();
+    std::string Format() override;
+
+    // Storage of the value of key, or nullptr if there is none. Valid
+    // until the table is modified.
+    Object** Find(Object* key);
+    // Mutators go through the cleaner's write barrier.
+    void Set(Object* key, Object* value, Cleaner* cleaner);
+    // Returns false if there was no such key.
+    bool Erase(Object* key);
+
+    size_t Count() const {
+        return count_;
+    }
+
+    template <typename F>
+    void ForEach(F f) const {
+        for (const Slot& slot : slots_) {
+            if (slot.hash != kEmpty) {
+                f(slot.key, slot.value);
+            }
+        }
+    }
+
+protected:
+    void Trace(Cleaner* cleaner) override;
+
+private:
+    // Hash of a free slot.
+    static constexpr uint64_t kEmpty = 0;
+    static constexpr size_t kMinCapacity = 8;
+
+    struct Slot {
+        uint64_t hash;
+        Object* key;
+        Object* value;
+    };
+
+    // Index of the slot holding key, or of the empty slot ending its probe
+    // sequence. The table must not be empty.
+    size_t Probe(Object* key, uint64_t hash) const;
+    void Grow();
+
+    std::vector<Slot> slots_;
+    size_t count_;
+};
+
+// Hash consistent with the key equality of HashTable; never 0.
+uint64_t HashKey(Object* key);
+bool KeysEqual(Object* first, Object* second);
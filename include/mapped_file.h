@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// A file mapped read-only into memory for as long as the object lives.
+// Throws std::system_error if the file cannot be opened or mapped, or is not
+// a regular file.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    std::string_view View() const {
+        return {data_, size_};
+    }
+
+private:
+    // Empty files are not mapped and data_ stays null.
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
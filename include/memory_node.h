@@ -1,15 +1,28 @@
 #pragma once
 
+#include <cstdint>
 #include <cstdlib>
 #include <memory>
+#include <string_view>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
-#include <unordered_set>
+#include "allocator.h"
 
 class Object;
 class Cleaner;
 class Scope;
+class Environment;
+class Symbol;
+
+// Low pointer bits that mark an immediate value (see object.h). Nodes are
+// allocated 16-byte aligned, so a pointer to a node never has them set.
+inline constexpr uintptr_t kImmediateTagMask = 0x3;
+
+inline bool IsImmediate(const void* ptr) {
+    return (reinterpret_cast<uintptr_t>(ptr) & kImmediateTagMask) != 0;
+}
 
 
 class MemoryNode {
@@ -19,40 +32,178 @@ public:
     MemoryNode() = default;
     virtual ~MemoryNode() = default;
 protected:
-    void AddDependency(MemoryNode* obj);
-    void RemoveDependency(MemoryNode* obj);
-    void SetMark();
-    void ResetMark();
+    // Reports every node directly referenced by this one via cleaner->Visit.
+    // Nodes without outgoing references keep the empty default.
+    virtual void Trace(Cleaner* cleaner);
+
+    bool marked_ = false;
+    // Survived at least one collection and lives in the old generation.
+    bool old_ = false;
+    // Already recorded in the cleaner's remembered set.
+    bool remembered_ = false;
+};
 
-    std::unordered_set<MemoryNode*> dependencies_;
-    std::unordered_set<MemoryNode*> upper_dependencies_;
-    bool marked_;
 
+// Memory outside of the heap that references nodes, such as the stack of
+// the virtual machine. A registered set reports its references on every
+// collection.
+class RootSet {
+public:
+    virtual void TraceRoots(Cleaner* cleaner) = 0;
+
+protected:
+    ~RootSet() = default;
 };
 
 
+// Generational mark-and-sweep collector.
+//
+// New objects start in the young generation. A minor collection marks
+// from the roots and the remembered set, never traces into old objects,
+// frees unreachable young objects and promotes the survivors in place.
+// Objects are not moved because raw pointers to them are held on the C++
+// stack. Old objects are only reclaimed by a full collection, triggered
+// when the old generation outgrows its threshold. A full collection walks
+// the allocator pages linearly instead of a list of nodes.
 class Cleaner {
 public:
-    Cleaner() = default;
+    // Upper bound on the number of pending entries in the mark stack.
+    static constexpr size_t kDefaultMarkStackLimit = 1 << 20;
+    // Old generation size, in objects, below which no full collection runs.
+    static constexpr size_t kMinGcThreshold = 1 << 14;
+    // Number of young objects that triggers a minor collection.
+    static constexpr size_t kNurserySize = 1 << 12;
+
+    explicit Cleaner(size_t mark_stack_limit = kDefaultMarkStackLimit);
+
+    Cleaner(const Cleaner&) = delete;
+    Cleaner& operator=(const Cleaner&) = delete;
+    ~Cleaner();
 
     template<typename T, typename... Args>
     requires std::is_base_of_v<MemoryNode, T>
-    Object* Make(Args... args) {
-        auto new_obj = new T(std::forward<Args>(args)...);
-        nodes_.push_back(static_cast<MemoryNode*>(new_obj));
-        return new_obj;
+    T* Make(Args... args) {
+        return Allocate<T>(std::forward<Args>(args)...);
     }
 
+    Scope* MakeScope();
     Scope* MakeScope(Scope* parent_scope);
+    // Call frame with slots_count local slots, all empty.
+    Environment* MakeEnvironment(Environment* parent, size_t slots_count);
 
-    void Sweep(MemoryNode* main_scope);
+    // Returns the only symbol with this name in the heap, creating it on
+    // first use. The table is weak: a symbol nothing references is
+    // collected like any other node, and only the well-known ones are
+    // pinned.
+    Symbol* Intern(std::string_view name);
+
+    // Full collection of everything unreachable from the registered roots
+    // and from main_scope, if given.
+    void Sweep(MemoryNode* main_scope = nullptr);
+    // Minor collection of the young generation only.
+    void SweepYoung();
     void DeleteAll();
 
-    static const std::unique_ptr<Cleaner> kCleaner;
-    static int counter;
+    // Collects if a generation has grown past its threshold. Callers must
+    // make sure every live temporary is reachable from a root.
+    void SafePoint() {
+        if (young_nodes_.size() >= kNurserySize) {
+            SweepYoung();
+            if (allocator_.LiveCount() >= gc_threshold_) {
+                Sweep();
+            }
+        }
+    }
+
+    // Must be called after storing value into a field of holder once
+    // holder is constructed, so that old-to-young references are found
+    // by minor collections.
+    void WriteBarrier(MemoryNode* holder, MemoryNode* value) {
+        if (holder->old_ && value != nullptr && !IsImmediate(value) && !value->old_ &&
+            !holder->remembered_) {
+            holder->remembered_ = true;
+            remembered_.push_back(holder);
+        }
+    }
+
+    void AddRoot(MemoryNode* node);
+    void RemoveRoot(MemoryNode* node);
+    void AddRootSet(RootSet* roots);
+    void RemoveRootSet(RootSet* roots);
+
+    // Whether the collection now marking, or the last one, is minor.
+    bool IsMinorCollection() const {
+        return young_only_;
+    }
+
+    size_t HeapSize() const;
+    size_t CollectionsCount() const;
+    size_t MinorCollectionsCount() const;
+
+    // Called from MemoryNode::Trace for each outgoing reference.
+    void Visit(MemoryNode* node);
 
 private:
+    template<typename T, typename... Args>
+    T* Allocate(Args&&... args) {
+        static_assert(sizeof(T) <= SlabAllocator::kMaxSlotSize);
+        return AllocateSized<T>(sizeof(T), std::forward<Args>(args)...);
+    }
+
+    // For nodes that keep a variable part right after themselves.
+    template<typename T, typename... Args>
+    T* AllocateSized(size_t size, Args&&... args) {
+        static_assert(alignof(T) <= SlabAllocator::kSlotAlignment);
+        void* memory = allocator_.Allocate(size);
+        T* new_obj;
+        try {
+            new_obj = new (memory) T(std::forward<Args>(args)...);
+        } catch (...) {
+            allocator_.Free(memory);
+            throw;
+        }
+        young_nodes_.push_back(static_cast<MemoryNode*>(new_obj));
+        return new_obj;
+    }
+
     void Mark(MemoryNode* main_scope);
-    void UnmarkAll();
-    std::vector<MemoryNode*> nodes_;
-};
\ No newline at end of file
+    void MarkRoots();
+    void DrainMarkStack();
+    void RescanMarked();
+    void ForgetRemembered();
+    // Drops unmarked symbols from the table before they are destroyed.
+    void ForgetUnmarkedSymbols();
+    // Destroys the node and returns its slot to the allocator.
+    void Destroy(MemoryNode* node);
+    // Frees an unmarked node, or unmarks and promotes a marked one.
+    void SweepNode(MemoryNode* node);
+
+    SlabAllocator allocator_;
+    std::vector<MemoryNode*> young_nodes_;
+    // Old nodes that may reference young ones.
+    std::vector<MemoryNode*> remembered_;
+    bool young_only_ = false;
+
+    // Long-lived roots, such as global scopes.
+    std::vector<MemoryNode*> roots_;
+    std::vector<RootSet*> root_sets_;
+
+    // Keys point into the names stored by the symbols themselves.
+    std::unordered_map<std::string_view, Symbol*> symbols_;
+    // Symbols interned since the last collection, the only ones a minor
+    // collection may free.
+    std::vector<Symbol*> young_symbols_;
+    uint32_t next_symbol_id_;
+
+    size_t gc_threshold_ = kMinGcThreshold;
+    size_t collections_count_ = 0;
+    size_t minor_collections_count_ = 0;
+
+    // Nodes that are marked but whose references are not traced yet.
+    // When the stack is full further nodes are only marked and the
+    // overflow flag is raised; RescanMarked then re-traces every marked
+    // node to pick up the references that were dropped.
+    std::vector<MemoryNode*> mark_stack_;
+    size_t mark_stack_limit_;
+    bool mark_stack_overflowed_ = false;
+};
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "bytecode.h"
+#include "compiler.h"
+#include "memory_node.h"
+#include "object.h"
+
+// Code built by the analyzer (see analyzer.h). Every decision that
+// depends on the source only, such as which special form a list is or
+// where a variable lives, is made once when the node is built. Nodes are
+// heap objects so that constants and nested code are traced by the
+// collector; they are compiled to bytecode (see compiler.h) to run.
+class Node : public MemoryNode {
+public:
+    // Emits code that leaves the value of the expression on the stack.
+    virtual void Compile(Compiler* compiler) = 0;
+    // Emits code that returns the value from the current frame. Calls in
+    // tail position reuse the frame instead of nesting in it.
+    virtual void CompileTail(Compiler* compiler);
+
+    // The name, if this node reads a global variable.
+    virtual Symbol* GlobalName() {
+        return nullptr;
+    }
+};
+
+class ConstantNode : public Node {
+public:
+    explicit ConstantNode(Object* value);
+    void Compile(Compiler* compiler) override;
+
+protected:
+    void Trace(Cleaner* cleaner) override;
+
+private:
+    Object* value_;
+};
+
+// Slot of a local variable, depth frames above the current one.
+class LocalRefNode : public Node {
+public:
+    LocalRefNode(uint32_t depth, uint32_t slot);
+    void Compile(Compiler* compiler) override;
+
+private:
+    uint32_t depth_;
+    uint32_t slot_;
+};
+
+class GlobalRefNode : public Node {
+public:
+    explicit GlobalRefNode(Symbol* name);
+    void Compile(Compiler* compiler) override;
+    Symbol* GlobalName() override;
+
+protected:
+    void Trace(Cleaner* cleaner) override;
+
+private:
+    Symbol* name_;
+};
+
+// define or set! of a local variable.
+class SetLocalNode : public Node {
+public:
+    SetLocalNode(uint32_t depth, uint32_t slot, Node* value);
+    void Compile(Compiler* compiler) override;
+
+protected:
+    void Trace(Cleaner* cleaner) override;
+
+private:
+    uint32_t depth_;
+    uint32_t slot_;
+    Node* value_;
+};
+
+// define or set! of a global variable. set! requires the name to exist.
+class SetGlobalNode : public Node {
+public:
+    SetGlobalNode(Symbol* name, Node* value, bool is_define);
+    void Compile(Compiler* compiler) override;
+
+protected:
+    void Trace(Cleaner* cleaner) override;
+
+private:
+    Symbol* name_;
+    Node* value_;
+    bool is_define_;
+};
+
+class IfNode : public Node {
+public:
+    // false_branch is nullptr when the if has none.
+    IfNode(Node* condition, Node* true_branch, Node* false_branch);
+    void Compile(Compiler* compiler) override;
+    void CompileTail(Compiler* compiler) override;
+
+protected:
+    void Trace(Cleaner* cleaner) override;
+
+private:
+    Node* condition_;
+    Node* true_branch_;
+    Node* false_branch_;
+};
+
+// and (StopOnTrue = false) and or (StopOnTrue = true).
+template <bool StopOnTrue>
+class LogicNode : public Node {
+public:
+    explicit LogicNode(std::vector<Node*> tests) : tests_(std::move(tests)) {}
+
+    void Compile(Compiler* compiler) override {
+        CompileTests(compiler, false);
+    }
+
+    // The last test is in tail position, the others jump to a RETURN.
+    void CompileTail(Compiler* compiler) override {
+        CompileTests(compiler, true);
+    }
+
+protected:
+    void Trace(Cleaner* cleaner) override {
+        for (Node* test : tests_) {
+            cleaner->Visit(test);
+        }
+    }
+
+private:
+    void CompileTests(Compiler* compiler, bool tail) {
+        if (tests_.empty()) {
+            compiler->Emit(Opcode::CONST, compiler->AddObject(ConstructBool(!StopOnTrue)));
+            if (tail) {
+                compiler->Emit(Opcode::RETURN);
+            }
+            return;
+        }
+        std::vector<size_t> exits;
+        for (size_t i = 0; i + 1 < tests_.size(); ++i) {
+            tests_[i]->Compile(compiler);
+            exits.push_back(compiler->EmitJump(StopOnTrue ? Opcode::JUMP_IF_TRUE_OR_POP
+                                                          : Opcode::JUMP_IF_FALSE_OR_POP));
+        }
+        if (tail) {
+            tests_.back()->CompileTail(compiler);
+        } else {
+            tests_.back()->Compile(compiler);
+        }
+        for (size_t exit : exits) {
+            compiler->PatchJump(exit);
+        }
+        if (tail && !exits.empty()) {
+            compiler->Emit(Opcode::RETURN);
+        }
+    }
+
+    std::vector<Node*> tests_;
+};
+
+using AndNode = LogicNode<false>;
+using OrNode = LogicNode<true>;
+
+// A lambda expression. It is analyzed once; every evaluation only pairs
+// it with the current frame into a new LambdaScheme. The body is compiled
+// on the first call and kept.
+class LambdaNode : public Node {
+public:
+    // locals holds the parameters followed by the names the body defines.
+    LambdaNode(size_t args_count, std::vector<Symbol*> locals, std::vector<Node*> body);
+    void Compile(Compiler* compiler) override;
+
+    size_t ArgsCount() const {
+        return args_count_;
+    }
+    size_t LocalsCount() const {
+        return locals_.size();
+    }
+    Code* GetBytecode(Cleaner* cleaner);
+
+protected:
+    void Trace(Cleaner* cleaner) override;
+
+private:
+    size_t args_count_;
+    std::vector<Symbol*> locals_;
+    std::vector<Node*> body_;
+    Code* bytecode_;
+};
+
+// Application of a procedure or a builtin to a fixed number of arguments.
+class CallNode : public Node {
+public:
+    CallNode(Node* callee, std::vector<Node*> args);
+    void Compile(Compiler* compiler) override;
+    void CompileTail(Compiler* compiler) override;
+
+protected:
+    void Trace(Cleaner* cleaner) override;
+
+private:
+    // Emits everything but the call of a procedure itself; returns false
+    // if the call was done by a builtin opcode instead.
+    bool CompileOperands(Compiler* compiler);
+
+    Node* callee_;
+    std::vector<Node*> args_;
+};
@@ -1,146 +1,317 @@
 #pragma once
 
+#include <cstdint>
+#include <span>
 #include <type_traits>
 #include <unordered_map>
 #include "error.h"
 #include "memory_node.h"
 #include <string>
+#include <string_view>
 #include <vector>
 
 class Scope;
+class Environment;
 class Operation;
+class LambdaNode;
+
+// Dynamic type of a heap object, checked by Is and As instead of RTTI.
+enum class ObjectType : uint8_t {SYMBOL, CELL, VECTOR, HASH_TABLE, LAMBDA_SCHEME, OP_HOLDER};
 
 class Object : public MemoryNode {
     friend Scope;
 public:
-    virtual Object* Exec(Scope* scope) = 0;
+    explicit Object(ObjectType type) : type_(type) {}
+
     virtual std::string Format() = 0;
+
+    ObjectType GetType() const {
+        return type_;
+    }
+
+private:
+    // Fits into the tail padding of MemoryNode.
+    ObjectType type_;
 };
 
-Object* FindElemInScope(const std::string& name, Scope* scope);
-Scope* FindScope(const std::string& name, Scope* scope);
+Object* FindElemInScope(Symbol* name, Scope* scope);
+Scope* FindScope(Symbol* name, Scope* scope);
 
+// Named bindings: the global environment, or a scope built directly in tests.
+// Locals of procedures live in Environment frames instead.
 class Scope : public MemoryNode{
 public:
-    Scope();
-    Scope(Scope* parent_scope);
-    bool IsInScope(const std::string& name);
-    Object* RetObj(const std::string& name);
+    // Global scope with every builtin installed.
+    Scope(Cleaner* cleaner);
+    Scope(Cleaner* cleaner, Scope* parent_scope);
+    bool IsInScope(Symbol* name);
+    Object* RetObj(Symbol* name);
+    // Storage of a named entry, or nullptr if there is none. Names are
+    // never removed, so it stays valid as long as the scope and sees
+    // every later AddName of the name.
+    Object** FindBinding(Symbol* name);
     Scope* RetParentScope();
-    void AddName(const std::string& name, Object* obj);
+    Cleaner* GetCleaner();
+    void AddName(Symbol* name, Object* obj);
+
+protected:
+    void Trace(Cleaner* cleaner) override;
 
 private:
+    Cleaner* cleaner_;
     Scope* parent_scope_;
-    std::unordered_map<std::string, Object*> scope_map_;
+    // Symbols are interned, so they are compared by pointer.
+    std::unordered_map<Symbol*, Object*> scope_map_;
 };
 
-class Number : public Object {
+// Call frame of a procedure: its locals, at the slots the analyzer gave
+// them, and the frame the procedure was created in. Top-level procedures
+// have no parent. Created by Cleaner::MakeEnvironment, which stores up to
+// kInlineSlots slots in the same slab slot as the frame itself.
+class Environment : public MemoryNode {
 public:
-    Number(int val);
-    int GetValue() const;
-    Object* Exec(Scope* scope) override;
-    std::string Format() override;
+    static const size_t kInlineSlots;
+
+    Environment(Environment* parent, size_t slots_count);
+    ~Environment() override;
+
+    Environment(const Environment&) = delete;
+    Environment& operator=(const Environment&) = delete;
+
+    // Bytes to allocate for a frame with slots_count slots.
+    static size_t AllocationSize(size_t slots_count);
+
+    Environment* GetParent() const {
+        return parent_;
+    }
+    Object* GetSlot(size_t slot) const {
+        return slots_[slot];
+    }
+    // Goes through the cleaner's write barrier.
+    void SetSlot(size_t slot, Object* obj, Cleaner* cleaner);
+
+protected:
+    void Trace(Cleaner* cleaner) override;
+
 private:
-    int val_;
+    Environment* parent_;
+    size_t slots_count_;
+    // Points right past the object when the slots are inline.
+    Object** slots_;
 };
 
 class Symbol : public Object {
 public:
-    Symbol(const std::string& val);
+    static bool ClassOf(const Object* obj) {
+        return obj->GetType() == ObjectType::SYMBOL;
+    }
+
+    // Ids of names the interpreter itself looks for. Cleaner::Intern gives
+    // them to kWellKnownNames and numbers every other symbol from kFirstFreeId.
+    enum WellKnownId : uint32_t {
+        kQuoteId, kLambdaId, kDefineId, kSetId, kIfId, kAndId, kOrId, kFirstFreeId
+    };
+    static constexpr std::string_view kWellKnownNames[kFirstFreeId] = {
+        "quote", "lambda", "define", "set!", "if", "and", "or"
+    };
+
+    // Symbols are created through Cleaner::Intern only.
+    Symbol(std::string val, uint32_t id);
     const std::string& GetName() const;
-    Object* Exec(Scope* scope) override;
+    uint32_t GetId() const;
     std::string Format() override;
 private:
     std::string val_;
+    uint32_t id_;
 };
 
 class Cell : public Object {
 public:
+    static bool ClassOf(const Object* obj) {
+        return obj->GetType() == ObjectType::CELL;
+    }
+
     Cell(Object* first, Object* second);
-    Object* Exec(Scope* scope) override;
     std::string Format() override;
 
     Object* GetFirst() const;
     Object* GetSecond() const;
 
-    void SetFirst(Object*);
-    void SetSecond(Object*);
+    // Mutators of a constructed cell go through the cleaner's write barrier.
+    void SetFirst(Object*, Cleaner* cleaner);
+    void SetSecond(Object*, Cleaner* cleaner);
+
+protected:
+    void Trace(Cleaner* cleaner) override;
 
-    void SetName(const std::string&);
-    Object* GetName();
 private:
     Object* first_;
     Object* second_;
-    Object* name_;
 };
 
-
-class LambdaScheme : public Object {
+// Fixed-size array of objects with constant-time access, printed as #(...).
+class Vector : public Object {
 public:
-    LambdaScheme(Object* arg, Scope* scope,
-                    bool is_sugar = false,
-                    bool is_context_capturer = true);
-    bool IsCC();
-    const std::vector<std::string>& ReturnArgs() const;
-    const std::vector<Object*> ReturnFuncs() const;
-    std::string& GetName();
-    Scope* GetCCScope();
+    static bool ClassOf(const Object* obj) {
+        return obj->GetType() == ObjectType::VECTOR;
+    }
 
+    Vector(size_t size, Object* fill);
+    explicit Vector(std::vector<Object*> elements);
     std::string Format() override;
-    Object* Exec(Scope* scope) override;
+
+    size_t Size() const {
+        return elements_.size();
+    }
+    Object* Get(size_t index) const {
+        return elements_[index];
+    }
+
+    // Mutators go through the cleaner's write barrier.
+    void Set(size_t index, Object* obj, Cleaner* cleaner);
+    void Fill(Object* obj, Cleaner* cleaner);
+
+protected:
+    void Trace(Cleaner* cleaner) override;
+
 private:
-    inline void ThrowSyntax() {
-        throw SyntaxError("Incorrect args for lambda definition");
+    std::vector<Object*> elements_;
+};
+
+
+// A procedure: analyzed code together with the frame it was created in.
+class LambdaScheme : public Object {
+public:
+    static bool ClassOf(const Object* obj) {
+        return obj->GetType() == ObjectType::LAMBDA_SCHEME;
     }
 
-    bool is_context_capturer_;
-    std::string name_;
-    Scope* scope_;
-    std::vector<std::string> lambda_args_;
-    std::vector<Object*> functions_;
+    LambdaScheme(LambdaNode* code, Environment* env);
+    LambdaNode* GetCode();
+    Environment* GetClosureEnv();
+
+    std::string Format() override;
+
+protected:
+    void Trace(Cleaner* cleaner) override;
+
+private:
+    LambdaNode* code_;
+    Environment* env_;
 };
 
 
 
 class BaseOpHolder : public Object {
 public:
-    BaseOpHolder() = default;
+    static bool ClassOf(const Object* obj) {
+        return obj->GetType() == ObjectType::OP_HOLDER;
+    }
 
-    virtual Object* MakeOp(Object* arg_obj, Scope* scope) = 0;
+    // Arguments are a view of the caller's evaluated values, not a copy.
+    using Arguments = std::span<Object* const>;
+    using Entry = Object* (*)(Arguments arguments, Cleaner* cleaner);
 
-    std::string Format() final {
-        throw RuntimeError("Uncallable");
+    // entry runs the builtin and tells builtins apart. It is the builtin
+    // itself for those of fixed arity (see ops.h) or OpHolder<F>::Run.
+    explicit BaseOpHolder(Entry entry) : Object(ObjectType::OP_HOLDER), entry_(entry) {}
+
+    Object* Apply(Arguments arguments, Cleaner* cleaner) {
+        return entry_(arguments, cleaner);
+    }
+
+    Entry GetEntry() const {
+        return entry_;
     }
-    Object* Exec(Scope* scope) final { //NOLINT
+
+    std::string Format() final {
         throw RuntimeError("Uncallable");
     }
+
+private:
+    Entry entry_;
 };
 
+// Whether obj holds the builtin with this entry point.
+inline bool IsBuiltin(Object* obj, BaseOpHolder::Entry entry) {
+    return obj != nullptr && !IsImmediate(obj) && BaseOpHolder::ClassOf(obj) &&
+           static_cast<BaseOpHolder*>(obj)->GetEntry() == entry;
+}
+
+// Holder of a builtin with optional or any number of arguments, run by an
+// Operation of type F.
 template<typename F>
-requires std::is_base_of_v<Operation, F> || std::is_same_v<LambdaScheme, F>
+requires std::is_base_of_v<Operation, F>
 
 class OpHolder : public BaseOpHolder {
 public:
-    OpHolder() = default;
+    static bool ClassOf(const Object* obj) {
+        return BaseOpHolder::ClassOf(obj) && static_cast<const BaseOpHolder*>(obj)->GetEntry() == &Run;
+    }
 
-    Object* MakeOp(Object* arg_obj, Scope* scope) override;
+    OpHolder() : BaseOpHolder(&Run) {}
+
+private:
+    static Object* Run(Arguments arguments, Cleaner* cleaner);
 };
 
 
+///////////////////////////////////////////////////////////////////////////////
+
+// Immediate values.
+// Integers and booleans are encoded in the Object* itself and never
+// allocated: a fixnum has the low bit set and keeps its value in the
+// remaining bits, a boolean ends in 0b10. The empty list is nullptr.
+// Number and Boolean are never defined, they only name these types for Is.
+
+class Number;
+class Boolean;
+
+inline constexpr uintptr_t kFixnumTag = 0x1;
+inline constexpr uintptr_t kBooleanTag = 0x2;
+inline constexpr uintptr_t kTrueBit = 0x4;
+
+inline Object* MakeNumber(int val) {
+    return reinterpret_cast<Object*>((static_cast<uintptr_t>(val) << 1) | kFixnumTag);
+}
+
+inline int GetNumber(Object* obj) {
+    return static_cast<int>(static_cast<intptr_t>(reinterpret_cast<uintptr_t>(obj)) >> 1);
+}
+
+inline Object* ConstructBool(bool val) {
+    return reinterpret_cast<Object*>(kBooleanTag | (val ? kTrueBit : 0));
+}
+
+// Only #f is false, every other value including the empty list is true.
+inline bool IsFalse(Object* obj) {
+    return obj == ConstructBool(false);
+}
+
+// Format that also accepts immediate values and the empty list.
+std::string FormatObject(Object* obj);
+
 ///////////////////////////////////////////////////////////////////////////////
 
 // Runtime type checking and convertion.
-// This can be helpful: https://en.cppreference.com/w/cpp/memory/shared_ptr/pointer_cast
+// Every heap class provides a static ClassOf that inspects the type tag.
 
 template <class T>
-T* As(Object* obj) {
-    return dynamic_cast<T*>(obj);
+bool Is(Object* obj) {
+    return obj != nullptr && !IsImmediate(obj) && T::ClassOf(obj);
 }
 
 template <class T>
-bool Is(Object* obj) {
-    return dynamic_cast<T*>(obj) != nullptr;
+T* As(Object* obj) {
+    return Is<T>(obj) ? static_cast<T*>(obj) : nullptr;
+}
+
+template <>
+inline bool Is<Number>(Object* obj) {
+    return (reinterpret_cast<uintptr_t>(obj) & kFixnumTag) != 0;
 }
 
-bool CheckIfCellIsValid(Cell* cell);
-Object* ConstructBool(bool val);
\ No newline at end of file
+template <>
+inline bool Is<Boolean>(Object* obj) {
+    return (reinterpret_cast<uintptr_t>(obj) & kImmediateTagMask) == kBooleanTag;
+}
@@ -3,4 +3,7 @@
 #include "object.h"
 #include "tokenizer.h"
 
-Object* Read(Tokenizer* tokenizer);
\ No newline at end of file
+// Objects are allocated in the heap of the given cleaner. Lists are read with
+// an explicit stack, so nesting depth and length are limited only by memory.
+// Read consumes the last token of the form but does not scan past it.
+Object* Read(Tokenizer* tokenizer, Cleaner* cleaner);
\ No newline at end of file
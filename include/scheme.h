@@ -1,11 +1,37 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include "memory_node.h"
+#include "vm.h"
+
+class Scope;
+class Tokenizer;
 
 class Interpreter {
 public:
+    // max_depth limits the depth of non-tail calls, see Machine.
+    explicit Interpreter(size_t max_depth = Machine::kDefaultMaxDepth);
     std::string Run(const std::string&);
+    // Reads the next top-level form from tokenizer and evaluates it, so
+    // forms of a stream run one at a time in order. The token after the
+    // form is not read until the form has run. Returns false at the end of
+    // the input. A malformed form text throws ReadError, after which the
+    // tokenizer cannot go on; other errors leave it at the next form.
+    bool RunNext(Tokenizer* tokenizer, std::string* result);
     ~Interpreter();
+
+    Cleaner* GetCleaner();
 private:
-    std::string PreprocessInputStr(std::string str);
+    std::string Eval(Object* parsed_obj);
+    // Returns str or its modified copy, kept in storage.
+    std::string_view PreprocessInputStr(std::string_view str, std::string* storage);
+
+    // Heap owning every object of this interpreter. Interpreters share no
+    // state, so separate instances may run on separate threads.
+    Cleaner cleaner_;
+    // Global environment, created once with all builtins installed.
+    // Definitions made by one Run are visible to the next ones.
+    Scope* global_scope_;
+    Machine machine_;
 };
@@ -1,10 +1,13 @@
 #pragma once
 
-#include <variant>
 #include <istream>
+#include <string>
+#include <string_view>
+#include <variant>
 
 struct SymbolToken {
-    std::string name;
+    // Points into the tokenizer's source, valid until the next call of Next.
+    std::string_view name;
 
     bool operator==(const SymbolToken& other) const;
 };
@@ -34,31 +37,47 @@ struct BooleanToken {
 using Token =
     std::variant<ConstantToken, BracketToken, SymbolToken, QuoteToken, DotToken, BooleanToken>;
 
+// Splits Scheme source into tokens.
+//
+// A tokenizer over a string_view scans it in place and the caller keeps it
+// alive. A tokenizer over a stream reads it a chunk at a time, whenever the
+// buffer runs out before a whole token, so data written to the stream later
+// is seen. Its buffer holds at most a chunk and the token being read.
+//
+// Next only consumes the current token. The one after it is scanned when
+// IsEnd or GetToken asks for it, so a caller that stops after the last
+// token of a form does not wait for or fail on the input that follows.
 class Tokenizer {
 public:
+    static constexpr std::streamsize kChunkSize = 1 << 16;
+
+    explicit Tokenizer(std::string_view source);
     Tokenizer(std::istream* in);
 
+    Tokenizer(const Tokenizer&) = delete;
+    Tokenizer& operator=(const Tokenizer&) = delete;
+
     bool IsEnd();
 
     void Next();
 
-    Token GetToken();
+    const Token& GetToken();
 
 private:
-    bool IsDot(const char& ch);
-    bool IsQuote(const char& ch);
-    bool IsOpenBracket(const char& ch);
-    bool IsCloseBracket(const char& ch);
-    bool IsPlusMinus(const char& ch);
-    bool IsDigit(const char& ch);
-    bool IsOpeningSymbol(const char& ch);
-    bool IsInnerSymbol(const char& ch);
-    bool IsValid(const char& ch);
-
-    int ReadNum(char& ch);
-    std::string ReadSymbols(char& ch);
+    // Appends up to a chunk of what the stream has to buffer_, dropping
+    // consumed input. Returns false if the stream has nothing more for now.
+    bool Refill();
+    void Advance();
+    bool HasDelimiter() const;
+    void SkipSpaces();
+    int ReadNum(size_t begin);
 
     Token curr_token_;
+    std::string_view source_;
+    size_t pos_;
     std::istream* in_;
+    std::string buffer_;
     bool is_end_;
-};
\ No newline at end of file
+    // The current token is consumed and the next one is not scanned yet.
+    bool pending_;
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "bytecode.h"
+#include "memory_node.h"
+#include "object.h"
+
+// Stack machine running compiled code (see bytecode.h).
+//
+// A call of a Scheme procedure pushes a frame on frames_ and continues in
+// the same loop, so Scheme recursion does not recurse in C++. Temporaries
+// live on stack_. Both are reported to the collector as roots.
+//
+// The depth of non-tail calls is limited by max_depth, going deeper
+// raises RuntimeError. Frames below the running one do not change, so a
+// minor collection scans only the frames that have run since the previous
+// collection and the stack above them.
+class Machine : public RootSet {
+public:
+    // About 80 bytes per frame with its environment.
+    static constexpr size_t kDefaultMaxDepth = 1 << 20;
+
+    Machine(Cleaner* cleaner, Scope* global_scope, size_t max_depth = kDefaultMaxDepth);
+    ~Machine();
+
+    Machine(const Machine&) = delete;
+    Machine& operator=(const Machine&) = delete;
+
+    // Runs top-level code in the global scope and returns its value.
+    Object* Run(Code* code);
+
+    void TraceRoots(Cleaner* cleaner) override;
+
+private:
+    struct Frame {
+        Code* code;
+        // Next instruction; up to date while the frame is not running.
+        const uint32_t* pc;
+        // Locals of the procedure, nullptr for top-level code.
+        Environment* env;
+        // Stack size when the frame was entered.
+        size_t stack_base;
+    };
+
+    // Runs until the frame at frames_base returns.
+    Object* Loop(size_t frames_base);
+    // Calls the value under the argc topmost ones with them as arguments.
+    // A procedure gets a new frame, or takes over the current one for a
+    // tail call, and true is returned. A builtin leaves its result instead.
+    bool Call(size_t argc, bool tail);
+    // Does the call of a builtin opcode in place if builtin is the one the
+    // opcode stands for and the arguments are the expected ones.
+    bool TryBuiltin(Opcode op, Object* builtin, Object** result);
+    // Value of the global named by object constant #index of code; the
+    // binding is cached in code after the first lookup.
+    Object* LookupGlobal(Code* code, uint32_t index);
+    // Called when frames_ shrinks, as its new top frame runs again.
+    void LowerUntouchedFrames() {
+        untouched_frames_ = std::min(untouched_frames_, frames_.empty() ? 0 : frames_.size() - 1);
+    }
+
+    Cleaner* cleaner_;
+    Scope* global_scope_;
+    size_t max_depth_;
+    std::vector<Object*> stack_;
+    std::vector<Frame> frames_;
+    // Number of bottom frames that have not run since the last collection,
+    // together with their part of stack_. What they reference is old.
+    size_t untouched_frames_ = 0;
+};
@@ -1,9 +1,106 @@
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
 #include <iostream>
+#include <string_view>
+#include <system_error>
 
 #include <error.h>
+#include "fd_stream.h"
+#include "mapped_file.h"
 #include "scheme.h"
+#include "tokenizer.h"
+
+namespace {
+
+// Evaluates the forms read from source, a string_view of the whole input or
+// a stream, one at a time and prints their results. An error in a form is
+// reported and the next form runs. Stops at a syntax error in the text of a
+// form, past which the input cannot be split into forms, or when the input
+// cannot be read.
+template <class Source>
+int RunForms(Source source) {
+    Interpreter interpreter;
+    try {
+        Tokenizer tokenizer(source);
+        std::string result;
+        while (true) {
+            try {
+                if (!interpreter.RunNext(&tokenizer, &result)) {
+                    return 0;
+                }
+                std::cout << result << '\n';
+            } catch (const ReadError&) {
+                throw;
+            } catch (const SyntaxError& syntax_error) {
+                std::cerr << "Caught SyntaxError: " << syntax_error.what() << std::endl;
+            } catch (const NameError& name_error) {
+                std::cerr << "Caught NameError: " << name_error.what() << std::endl;
+            } catch (const RuntimeError& runtime_error) {
+                std::cerr << "Caught RuntimeError: " << runtime_error.what() << std::endl;
+            } catch (const std::system_error&) {
+                throw;
+            } catch (...) {
+                std::cerr << "Caught unknown exception" << std::endl;
+            }
+        }
+    } catch (const SyntaxError& syntax_error) {
+        std::cerr << "Caught SyntaxError: " << syntax_error.what() << std::endl;
+    }
+    return 1;
+}
+
+// Reads fd in chunks, so memory is bounded by the largest form rather than
+// the input.
+int RunStream(int fd) {
+    FdStreamBuf buffer(fd);
+    std::istream in(&buffer);
+    in.tie(&std::cout);
+    return RunForms(&in);
+}
+
+int RunStream(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), path);
+    }
+    int status = RunStream(fd);
+    ::close(fd);
+    return status;
+}
+
+// Tokenizes the mapped file in place. Pipes and devices, such as /dev/stdin
+// or a process substitution, cannot be mapped and are read as a stream.
+int RunScript(const std::string& path) {
+    struct stat info;
+    if (::stat(path.c_str(), &info) == 0 && !S_ISREG(info.st_mode) && !S_ISDIR(info.st_mode)) {
+        return RunStream(path);
+    }
+    MappedFile file(path);
+    return RunForms(file.View());
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    // scheme-interpreter file runs a script, and scheme-interpreter --stream
+    // [file] reads forms from the file or the standard input in chunks.
+    // Both print results through the buffered std::cout; std::cerr flushes
+    // it before reporting an error.
+    if (argc >= 2) {
+        std::ios::sync_with_stdio(false);
+        try {
+            if (std::string_view(argv[1]) != "--stream") {
+                return RunScript(argv[1]);
+            }
+            return argc == 2 ? RunStream(STDIN_FILENO) : RunStream(argv[2]);
+        } catch (const std::system_error& error) {
+            std::cerr << error.what() << std::endl;
+            return 1;
+        }
+    }
 
-int main() {
     Interpreter interpreter;
     std::string query;
 
@@ -0,0 +1,89 @@
+#include "allocator.h"
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+SlabAllocator::~SlabAllocator() {
+    Release();
+}
+
+size_t SlabAllocator::Page::FirstSlotOffset() {
+    return (sizeof(Page) + kSlotAlignment - 1) / kSlotAlignment * kSlotAlignment;
+}
+
+char* SlabAllocator::Page::Slot(size_t index) {
+    return reinterpret_cast<char*>(this) + FirstSlotOffset() + index * slot_size;
+}
+
+size_t SlabAllocator::Page::IndexOf(void* slot) {
+    return (static_cast<char*>(slot) - Slot(0)) / slot_size;
+}
+
+SlabAllocator::Page* SlabAllocator::PageOf(void* slot) {
+    auto address = reinterpret_cast<uintptr_t>(slot);
+    return reinterpret_cast<Page*>(address & ~(static_cast<uintptr_t>(kPageSize) - 1));
+}
+
+SlabAllocator::Page* SlabAllocator::NewPage(size_t slot_size) {
+    void* memory = std::aligned_alloc(kPageSize, kPageSize);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    Page* page = new (memory) Page;
+    page->slot_size = slot_size;
+    page->slot_count = (kPageSize - Page::FirstSlotOffset()) / slot_size;
+    page->used_count = 0;
+    std::memset(page->live, 0, sizeof(page->live));
+    return page;
+}
+
+void* SlabAllocator::Allocate(size_t size) {
+    size_t class_index = (size + kSlotAlignment - 1) / kSlotAlignment - 1;
+    SizeClass& size_class = size_classes_[class_index];
+
+    void* slot = nullptr;
+    if (size_class.free_list != nullptr) {
+        slot = size_class.free_list;
+        size_class.free_list = size_class.free_list->next;
+    } else {
+        if (size_class.pages.empty() ||
+            size_class.pages.back()->used_count == size_class.pages.back()->slot_count) {
+            size_class.pages.push_back(NewPage((class_index + 1) * kSlotAlignment));
+        }
+        Page* page = size_class.pages.back();
+        slot = page->Slot(page->used_count++);
+    }
+
+    Page* page = PageOf(slot);
+    size_t index = page->IndexOf(slot);
+    page->live[index / 64] |= uint64_t{1} << (index % 64);
+    ++live_count_;
+    return slot;
+}
+
+void SlabAllocator::Free(void* slot) {
+    Page* page = PageOf(slot);
+    size_t index = page->IndexOf(slot);
+    page->live[index / 64] &= ~(uint64_t{1} << (index % 64));
+    --live_count_;
+
+    SizeClass& size_class = size_classes_[page->slot_size / kSlotAlignment - 1];
+    auto free_slot = static_cast<FreeSlot*>(slot);
+    free_slot->next = size_class.free_list;
+    size_class.free_list = free_slot;
+}
+
+void SlabAllocator::Release() {
+    for (auto& size_class : size_classes_) {
+        for (Page* page : size_class.pages) {
+            std::free(page);
+        }
+        size_class.pages.clear();
+        size_class.free_list = nullptr;
+    }
+    live_count_ = 0;
+}
+
+size_t SlabAllocator::LiveCount() const {
+    return live_count_;
+}
@@ -0,0 +1,257 @@
+#include "analyzer.h"
+#include <algorithm>
+#include <vector>
+#include "error.h"
+#include "memory_node.h"
+
+namespace {
+
+class Analyzer {
+public:
+    explicit Analyzer(Cleaner* cleaner) : cleaner_(cleaner) {}
+
+    Node* Analyze(Object* form) {
+        if (Is<Symbol>(form)) {
+            return AnalyzeVariable(As<Symbol>(form));
+        }
+        if (!Is<Cell>(form)) {
+            return cleaner_->Make<ConstantNode>(form);
+        }
+        Object* head = As<Cell>(form)->GetFirst();
+        Object* rest = As<Cell>(form)->GetSecond();
+        if (IsKeyword(head, Symbol::kQuoteId)) {
+            return AnalyzeQuote(rest);
+        }
+        if (IsKeyword(head, Symbol::kIfId)) {
+            return AnalyzeIf(rest);
+        }
+        if (IsKeyword(head, Symbol::kDefineId)) {
+            return AnalyzeDefine(rest);
+        }
+        if (IsKeyword(head, Symbol::kSetId)) {
+            return AnalyzeSet(rest);
+        }
+        if (IsKeyword(head, Symbol::kLambdaId)) {
+            if (!Is<Cell>(rest)) {
+                ThrowLambdaSyntax();
+            }
+            return AnalyzeLambda(As<Cell>(rest)->GetFirst(), As<Cell>(rest)->GetSecond());
+        }
+        if (IsKeyword(head, Symbol::kAndId)) {
+            return cleaner_->Make<AndNode>(AnalyzeElements(rest));
+        }
+        if (IsKeyword(head, Symbol::kOrId)) {
+            return cleaner_->Make<OrNode>(AnalyzeElements(rest));
+        }
+        Node* callee = Analyze(head);
+        return cleaner_->Make<CallNode>(callee, AnalyzeElements(rest));
+    }
+
+private:
+    Node* AnalyzeVariable(Symbol* name) {
+        uint32_t depth;
+        uint32_t slot;
+        if (Lookup(name, &depth, &slot)) {
+            return cleaner_->Make<LocalRefNode>(depth, slot);
+        }
+        return cleaner_->Make<GlobalRefNode>(name);
+    }
+
+    Node* AnalyzeQuote(Object* rest) {
+        if (!Is<Cell>(rest)) {
+            throw RuntimeError("Invalid arguments for Quote");
+        }
+        if (Is<Cell>(As<Cell>(rest)->GetSecond())) {
+            auto second_arg = As<Cell>(As<Cell>(rest)->GetSecond());
+            if (second_arg->GetFirst() == nullptr && second_arg->GetSecond() == nullptr) {
+                throw RuntimeError("Invalid arguments for Quote");
+            }
+        }
+        return cleaner_->Make<ConstantNode>(As<Cell>(rest)->GetFirst());
+    }
+
+    Node* AnalyzeIf(Object* rest) {
+        if (!Is<Cell>(rest)) {
+            throw SyntaxError("Wrong syntax for if statement");
+        }
+        std::vector<Node*> parts = AnalyzeElements(rest);
+        if (parts.size() < 2 || parts.size() > 3) {
+            throw SyntaxError("Wrong syntax for if statement");
+        }
+        return cleaner_->Make<IfNode>(parts[0], parts[1], parts.size() == 3 ? parts[2] : nullptr);
+    }
+
+    Node* AnalyzeDefine(Object* rest) {
+        if (!Is<Cell>(rest)) {
+            throw SyntaxError("Wrong syntax for Define");
+        }
+        Object* header = As<Cell>(rest)->GetFirst();
+        if (Is<Cell>(header)) {
+            // (define (name args...) body...)
+            Object* name = As<Cell>(header)->GetFirst();
+            if (!Is<Symbol>(name)) {
+                ThrowLambdaSyntax();
+            }
+            Node* lambda = AnalyzeLambda(As<Cell>(header)->GetSecond(), As<Cell>(rest)->GetSecond());
+            return MakeStore(As<Symbol>(name), lambda, true);
+        }
+        if (!Is<Symbol>(header)) {
+            throw SyntaxError("Wrong syntax for Define");
+        }
+        Object* value_list = As<Cell>(rest)->GetSecond();
+        Node* value = AnalyzeSingle(value_list, "Wrong syntax for Define");
+        return MakeStore(As<Symbol>(header), value, true);
+    }
+
+    Node* AnalyzeSet(Object* rest) {
+        if (!Is<Cell>(rest) || !Is<Symbol>(As<Cell>(rest)->GetFirst())) {
+            throw SyntaxError("Wrong syntax for Set");
+        }
+        Node* value = AnalyzeSingle(As<Cell>(rest)->GetSecond(), "Wrong syntax for Set");
+        return MakeStore(As<Symbol>(As<Cell>(rest)->GetFirst()), value, false);
+    }
+
+    Node* AnalyzeLambda(Object* params, Object* body) {
+        if (!Is<Cell>(params) && params != nullptr) {
+            ThrowLambdaSyntax();
+        }
+        std::vector<Symbol*> locals;
+        for (; params != nullptr; params = As<Cell>(params)->GetSecond()) {
+            if (!Is<Cell>(params) || !Is<Symbol>(As<Cell>(params)->GetFirst())) {
+                ThrowLambdaSyntax();
+            }
+            locals.push_back(As<Symbol>(As<Cell>(params)->GetFirst()));
+        }
+        if (!Is<Cell>(body)) {
+            ThrowLambdaSyntax();
+        }
+        size_t args_count = locals.size();
+
+        frames_.push_back(&locals);
+        CollectElements(body);
+        std::vector<Node*> body_nodes = AnalyzeElements(body);
+        frames_.pop_back();
+
+        return cleaner_->Make<LambdaNode>(args_count, std::move(locals), std::move(body_nodes));
+    }
+
+    // Analyzes every element of a proper list. The parser keeps 'x as the
+    // two elements quote and x, which give a single constant here.
+    std::vector<Node*> AnalyzeElements(Object* list) {
+        std::vector<Node*> nodes;
+        for (; Is<Cell>(list); list = As<Cell>(list)->GetSecond()) {
+            Object* elem = As<Cell>(list)->GetFirst();
+            Object* next = As<Cell>(list)->GetSecond();
+            if (IsKeyword(elem, Symbol::kQuoteId) && Is<Cell>(next)) {
+                nodes.push_back(cleaner_->Make<ConstantNode>(As<Cell>(next)->GetFirst()));
+                list = next;
+                continue;
+            }
+            nodes.push_back(Analyze(elem));
+        }
+        if (list != nullptr) {
+            throw RuntimeError("Cell structure is not valid");
+        }
+        return nodes;
+    }
+
+    // The only expression of list, as in the value of define and set!.
+    Node* AnalyzeSingle(Object* list, const char* error) {
+        if (!Is<Cell>(list)) {
+            throw SyntaxError(error);
+        }
+        std::vector<Node*> nodes = AnalyzeElements(list);
+        if (nodes.size() != 1) {
+            throw SyntaxError(error);
+        }
+        return nodes.front();
+    }
+
+    Node* MakeStore(Symbol* name, Node* value, bool is_define) {
+        uint32_t depth;
+        uint32_t slot;
+        if (Lookup(name, &depth, &slot)) {
+            return cleaner_->Make<SetLocalNode>(depth, slot, value);
+        }
+        return cleaner_->Make<SetGlobalNode>(name, value, is_define);
+    }
+
+    // Adds to the innermost frame the names defined by form, without
+    // entering quoted data and nested lambdas.
+    void CollectDefines(Object* form) {
+        if (!Is<Cell>(form)) {
+            return;
+        }
+        Object* head = As<Cell>(form)->GetFirst();
+        if (IsKeyword(head, Symbol::kQuoteId) || IsKeyword(head, Symbol::kLambdaId)) {
+            return;
+        }
+        if (IsKeyword(head, Symbol::kDefineId) && Is<Cell>(As<Cell>(form)->GetSecond())) {
+            Object* target = As<Cell>(As<Cell>(form)->GetSecond())->GetFirst();
+            if (Is<Cell>(target)) {
+                // (define (name args...) body...): the body is a nested lambda.
+                AddLocal(As<Cell>(target)->GetFirst());
+                return;
+            }
+            AddLocal(target);
+        }
+        CollectElements(form);
+    }
+
+    void CollectElements(Object* list) {
+        for (; Is<Cell>(list); list = As<Cell>(list)->GetSecond()) {
+            Object* elem = As<Cell>(list)->GetFirst();
+            if (IsKeyword(elem, Symbol::kQuoteId) && Is<Cell>(As<Cell>(list)->GetSecond())) {
+                list = As<Cell>(list)->GetSecond();
+                continue;
+            }
+            CollectDefines(elem);
+        }
+    }
+
+    void AddLocal(Object* name) {
+        std::vector<Symbol*>* locals = frames_.back();
+        if (Is<Symbol>(name) &&
+            std::find(locals->begin(), locals->end(), As<Symbol>(name)) == locals->end()) {
+            locals->push_back(As<Symbol>(name));
+        }
+    }
+
+    // Finds name in the innermost frame that has it; depth counts the
+    // frames passed on the way.
+    bool Lookup(Symbol* name, uint32_t* depth, uint32_t* slot) {
+        *depth = 0;
+        for (auto frame = frames_.rbegin(); frame != frames_.rend(); ++frame, ++*depth) {
+            auto it = std::find((*frame)->begin(), (*frame)->end(), name);
+            if (it != (*frame)->end()) {
+                *slot = static_cast<uint32_t>(it - (*frame)->begin());
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // A special form keyword that no local shadows.
+    bool IsKeyword(Object* obj, uint32_t id) {
+        if (!Is<Symbol>(obj) || As<Symbol>(obj)->GetId() != id) {
+            return false;
+        }
+        uint32_t depth;
+        uint32_t slot;
+        return !Lookup(As<Symbol>(obj), &depth, &slot);
+    }
+
+    [[noreturn]] static void ThrowLambdaSyntax() {
+        throw SyntaxError("Incorrect args for lambda definition");
+    }
+
+    Cleaner* cleaner_;
+    // Locals of the lambdas enclosing the form being analyzed, innermost last.
+    std::vector<std::vector<Symbol*>*> frames_;
+};
+
+}  // namespace
+
+Node* Analyze(Object* form, Cleaner* cleaner) {
+    return Analyzer(cleaner).Analyze(form);
+}
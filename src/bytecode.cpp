@@ -0,0 +1,17 @@
+#include "bytecode.h"
+#include <utility>
+#include "node.h"
+
+Code::Code(std::vector<uint32_t> instructions, std::vector<Object*> objects,
+           std::vector<LambdaNode*> lambdas)
+    : instructions_(std::move(instructions)), objects_(std::move(objects)),
+      lambdas_(std::move(lambdas)), bindings_(objects_.size(), nullptr) {}
+
+void Code::Trace(Cleaner* cleaner) {
+    for (Object* obj : objects_) {
+        cleaner->Visit(obj);
+    }
+    for (LambdaNode* lambda : lambdas_) {
+        cleaner->Visit(lambda);
+    }
+}
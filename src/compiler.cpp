@@ -0,0 +1,91 @@
+#include "compiler.h"
+#include <string_view>
+#include <utility>
+#include "error.h"
+#include "node.h"
+
+Compiler::Compiler(Cleaner* cleaner) : cleaner_(cleaner) {}
+
+void Compiler::Emit(Opcode op, uint32_t operand) {
+    if (operand > kMaxOperand) {
+        throw RuntimeError("Code is too large to compile");
+    }
+    instructions_.push_back(Encode(op, operand));
+}
+
+void Compiler::EmitWord(uint32_t word) {
+    instructions_.push_back(word);
+}
+
+size_t Compiler::EmitJump(Opcode op) {
+    Emit(op);
+    return instructions_.size() - 1;
+}
+
+void Compiler::PatchJump(size_t jump) {
+    if (instructions_.size() > kMaxOperand) {
+        throw RuntimeError("Code is too large to compile");
+    }
+    instructions_[jump] = Encode(DecodeOpcode(instructions_[jump]),
+                                 static_cast<uint32_t>(instructions_.size()));
+}
+
+uint32_t Compiler::AddObject(Object* obj) {
+    objects_.push_back(obj);
+    return static_cast<uint32_t>(objects_.size() - 1);
+}
+
+uint32_t Compiler::AddLambda(LambdaNode* lambda) {
+    lambdas_.push_back(lambda);
+    return static_cast<uint32_t>(lambdas_.size() - 1);
+}
+
+Code* Compiler::Finish() {
+    return cleaner_->Make<Code>(std::move(instructions_), std::move(objects_), std::move(lambdas_));
+}
+
+Code* CompileTopLevel(Node* node, Cleaner* cleaner) {
+    Compiler compiler(cleaner);
+    node->CompileTail(&compiler);
+    return compiler.Finish();
+}
+
+Code* CompileBody(const std::vector<Node*>& body, Cleaner* cleaner) {
+    Compiler compiler(cleaner);
+    for (size_t i = 0; i + 1 < body.size(); ++i) {
+        body[i]->Compile(&compiler);
+        compiler.Emit(Opcode::POP);
+    }
+    body.back()->CompileTail(&compiler);
+    return compiler.Finish();
+}
+
+bool FindBuiltinOpcode(Symbol* name, size_t argc, Opcode* op) {
+    struct Builtin {
+        std::string_view name;
+        size_t argc;
+        Opcode op;
+    };
+    static constexpr Builtin kBuiltins[] = {
+        {"+", 2, Opcode::ADD},
+        {"-", 2, Opcode::SUB},
+        {"*", 2, Opcode::MUL},
+        {"=", 2, Opcode::NUM_EQ},
+        {"<", 2, Opcode::LESS},
+        {">", 2, Opcode::GREATER},
+        {"<=", 2, Opcode::LESS_EQ},
+        {">=", 2, Opcode::GREATER_EQ},
+        {"cons", 2, Opcode::CONS},
+        {"car", 1, Opcode::CAR},
+        {"cdr", 1, Opcode::CDR},
+        {"null?", 1, Opcode::IS_NULL},
+        {"not", 1, Opcode::NOT},
+    };
+    for (const auto& builtin : kBuiltins) {
+        if (builtin.argc == argc && builtin.name == name->GetName()) {
+            *op = builtin.op;
+            return true;
+        }
+    }
+    return false;
+}
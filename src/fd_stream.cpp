@@ -0,0 +1,25 @@
+#include "fd_stream.h"
+#include <unistd.h>
+#include <cerrno>
+#include <system_error>
+
+FdStreamBuf::FdStreamBuf(int fd, size_t chunk_size) : fd_(fd), chunk_(chunk_size) {
+}
+
+FdStreamBuf::int_type FdStreamBuf::underflow() {
+    if (gptr() < egptr()) {
+        return traits_type::to_int_type(*gptr());
+    }
+    ssize_t count;
+    do {
+        count = ::read(fd_, chunk_.data(), chunk_.size());
+    } while (count < 0 && errno == EINTR);
+    if (count < 0) {
+        throw std::system_error(errno, std::generic_category(), "read");
+    }
+    if (count == 0) {
+        return traits_type::eof();
+    }
+    setg(chunk_.data(), chunk_.data(), chunk_.data() + count);
+    return traits_type::to_int_type(*gptr());
+}
@@ -0,0 +1,190 @@
+#include "hash_table.h"
+#include <algorithm>
+#include <set>
+#include <tuple>
+#include <utility>
+
+namespace {
+
+uint64_t Mix(uint64_t value) {
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ULL;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebULL;
+    value ^= value >> 31;
+    return value;
+}
+
+uint64_t HashAtom(Object* key) {
+    if (Is<Symbol>(key)) {
+        return As<Symbol>(key)->GetId();
+    }
+    // Immediates, the empty list and objects compared by identity.
+    return reinterpret_cast<uintptr_t>(key);
+}
+
+// Cells of a key that go into its hash. The rest of a longer or circular
+// key does not change it.
+constexpr size_t kHashedCells = 256;
+// Cells compared before KeysEqual starts remembering the pairs it has seen,
+// which makes it terminate on circular keys.
+constexpr size_t kUntrackedCells = 1 << 12;
+// Hashed in place of a list nested in a key.
+constexpr uint64_t kNestedList = 0x9e3779b97f4a7c15ULL;
+
+}  // namespace
+
+uint64_t HashKey(Object* key) {
+    uint64_t hash = 0;
+    size_t budget = kHashedCells;
+    // Nested lists wait here while the list holding them is walked along
+    // its cdrs, so neither direction uses the native stack.
+    std::vector<Object*> nested;
+    while (true) {
+        for (; Is<Cell>(key) && budget > 0; --budget) {
+            Object* first = As<Cell>(key)->GetFirst();
+            if (Is<Cell>(first)) {
+                hash = Mix(hash ^ kNestedList);
+                nested.push_back(first);
+            } else {
+                hash = Mix(hash ^ HashAtom(first));
+            }
+            key = As<Cell>(key)->GetSecond();
+        }
+        if (budget == 0) {
+            break;
+        }
+        hash = Mix(hash ^ HashAtom(key));
+        if (nested.empty()) {
+            break;
+        }
+        key = nested.back();
+        nested.pop_back();
+    }
+    return hash == 0 ? 1 : hash;
+}
+
+bool KeysEqual(Object* first, Object* second) {
+    size_t budget = kUntrackedCells;
+    std::vector<std::pair<Object*, Object*>> nested;
+    std::set<std::pair<Object*, Object*>> compared;
+    while (true) {
+        while (first != second) {
+            if (!Is<Cell>(first) || !Is<Cell>(second)) {
+                return false;
+            }
+            if (budget > 0) {
+                --budget;
+            } else if (!compared.emplace(first, second).second) {
+                // The pair is already being compared, which only happens on
+                // a cycle; equal so far means equal.
+                break;
+            }
+            Object* first_car = As<Cell>(first)->GetFirst();
+            Object* second_car = As<Cell>(second)->GetFirst();
+            if (first_car != second_car) {
+                if (!Is<Cell>(first_car) || !Is<Cell>(second_car)) {
+                    return false;
+                }
+                nested.emplace_back(first_car, second_car);
+            }
+            first = As<Cell>(first)->GetSecond();
+            second = As<Cell>(second)->GetSecond();
+        }
+        if (nested.empty()) {
+            return true;
+        }
+        std::tie(first, second) = nested.back();
+        nested.pop_back();
+    }
+}
+
+HashTable::HashTable() : Object(ObjectType::HASH_TABLE), count_(0) {}
+
+std::string HashTable::Format() {
+    return "#<hash-table>";
+}
+
+size_t HashTable::Probe(Object* key, uint64_t hash) const {
+    size_t mask = slots_.size() - 1;
+    size_t index = hash & mask;
+    while (slots_[index].hash != kEmpty) {
+        if (slots_[index].hash == hash && KeysEqual(slots_[index].key, key)) {
+            return index;
+        }
+        index = (index + 1) & mask;
+    }
+    return index;
+}
+
+Object** HashTable::Find(Object* key) {
+    if (count_ == 0) {
+        return nullptr;
+    }
+    Slot& slot = slots_[Probe(key, HashKey(key))];
+    return slot.hash == kEmpty ? nullptr : &slot.value;
+}
+
+void HashTable::Set(Object* key, Object* value, Cleaner* cleaner) {
+    if ((count_ + 1) * 4 > slots_.size() * 3) {
+        Grow();
+    }
+    uint64_t hash = HashKey(key);
+    Slot& slot = slots_[Probe(key, hash)];
+    if (slot.hash == kEmpty) {
+        slot.hash = hash;
+        slot.key = key;
+        ++count_;
+        cleaner->WriteBarrier(this, key);
+    }
+    slot.value = value;
+    cleaner->WriteBarrier(this, value);
+}
+
+bool HashTable::Erase(Object* key) {
+    if (count_ == 0) {
+        return false;
+    }
+    size_t mask = slots_.size() - 1;
+    size_t hole = Probe(key, HashKey(key));
+    if (slots_[hole].hash == kEmpty) {
+        return false;
+    }
+    // Moves back every following entry of the cluster that may not be
+    // separated from its home slot by the hole.
+    for (size_t next = (hole + 1) & mask; slots_[next].hash != kEmpty; next = (next + 1) & mask) {
+        size_t home = slots_[next].hash & mask;
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            slots_[hole] = slots_[next];
+            hole = next;
+        }
+    }
+    slots_[hole] = {kEmpty, nullptr, nullptr};
+    --count_;
+    return true;
+}
+
+void HashTable::Grow() {
+    std::vector<Slot> old_slots(std::max(kMinCapacity, 2 * slots_.size()), {kEmpty, nullptr, nullptr});
+    std::swap(slots_, old_slots);
+    size_t mask = slots_.size() - 1;
+    for (const Slot& slot : old_slots) {
+        if (slot.hash == kEmpty) {
+            continue;
+        }
+        size_t index = slot.hash & mask;
+        while (slots_[index].hash != kEmpty) {
+            index = (index + 1) & mask;
+        }
+        slots_[index] = slot;
+    }
+}
+
+void HashTable::Trace(Cleaner* cleaner) {
+    for (const Slot& slot : slots_) {
+        if (slot.hash != kEmpty) {
+            cleaner->Visit(slot.key);
+            cleaner->Visit(slot.value);
+        }
+    }
+}
@@ -1,84 +1,212 @@
 #include "memory_node.h"
 #include "object.h"
+#include <algorithm>
 #include <memory>
 
-const std::unique_ptr<Cleaner> Cleaner::kCleaner = std::make_unique<Cleaner>();
-int Cleaner::counter = 0;
+Cleaner::Cleaner(size_t mark_stack_limit)
+    : next_symbol_id_(Symbol::kFirstFreeId), mark_stack_limit_(mark_stack_limit) {}
 
-void MemoryNode::AddDependency(MemoryNode* obj) {
-    if (obj == nullptr || obj == this || dependencies_.contains(obj)) {
-            return;
-        }
-    dependencies_.insert(obj);
-    obj->upper_dependencies_.insert(this);
+Cleaner::~Cleaner() {
+    DeleteAll();
 }
 
-void MemoryNode::RemoveDependency(MemoryNode* obj) {
-   if (obj == nullptr || obj == this) {
-            return;
-        }
-    dependencies_.erase(obj);
-    obj->upper_dependencies_.erase(this);
+void MemoryNode::Trace(Cleaner*) {
 }
 
-void MemoryNode::SetMark() {
-    marked_ = true;
-    for (MemoryNode* dependants : dependencies_) {
-        if (!dependants->marked_) {
-            dependants->SetMark();
-        }
+void Cleaner::Sweep(MemoryNode* main_scope) {
+    young_only_ = false;
+    Mark(main_scope);
+    ForgetUnmarkedSymbols();
+
+    allocator_.ForEachLive([this](void* slot) {
+        SweepNode(static_cast<MemoryNode*>(slot));
+    });
+    young_nodes_.clear();
+    young_symbols_.clear();
+    ForgetRemembered();
+
+    gc_threshold_ = std::max(kMinGcThreshold, 2 * allocator_.LiveCount());
+    ++collections_count_;
+}
+
+void Cleaner::SweepYoung() {
+    young_only_ = true;
+    Mark(nullptr);
+    ForgetUnmarkedSymbols();
+
+    for (MemoryNode* node : young_nodes_) {
+        SweepNode(node);
     }
+    young_nodes_.clear();
+    young_symbols_.clear();
+    ForgetRemembered();
+
+    ++collections_count_;
+    ++minor_collections_count_;
 }
 
-void MemoryNode::ResetMark() {
-    marked_ = false;
+void Cleaner::SweepNode(MemoryNode* node) {
+    if (!node->marked_) {
+        Destroy(node);
+    } else {
+        node->marked_ = false;
+        node->old_ = true;
+    }
 }
 
-void Cleaner::Sweep(MemoryNode* main_scope) {
-    UnmarkAll();
-    Mark(main_scope);
+void Cleaner::Destroy(MemoryNode* node) {
+    node->~MemoryNode();
+    allocator_.Free(node);
+}
 
-    std::vector<MemoryNode*> new_nodes;
-    for (auto& curr_obj : nodes_) {
-        if (curr_obj == nullptr) {
-            continue;
-        }
-        if (!curr_obj->marked_) {
-            for (MemoryNode* upper_obj : curr_obj->upper_dependencies_) {
-                upper_obj->dependencies_.erase(curr_obj);     
-            }
-            for (MemoryNode* lower_obj : curr_obj->dependencies_) {
-                lower_obj->upper_dependencies_.erase(curr_obj);
+void Cleaner::ForgetRemembered() {
+    for (MemoryNode* holder : remembered_) {
+        holder->remembered_ = false;
+    }
+    remembered_.clear();
+}
+
+void Cleaner::ForgetUnmarkedSymbols() {
+    auto unmarked = [](Symbol* symbol) { return !symbol->marked_; };
+    if (young_only_) {
+        for (Symbol* symbol : young_symbols_) {
+            if (unmarked(symbol)) {
+                symbols_.erase(symbol->GetName());
             }
-            delete curr_obj;
-        } else {
-            new_nodes.push_back(curr_obj);
         }
+    } else {
+        std::erase_if(symbols_, [&unmarked](const auto& entry) { return unmarked(entry.second); });
     }
-    nodes_ = std::move(new_nodes);
+}
+
+Scope* Cleaner::MakeScope() {
+    return Allocate<Scope>(this);
 }
 
 Scope* Cleaner::MakeScope(Scope* parent_scope) {
-    auto new_scope = new Scope(parent_scope);
-    nodes_.push_back(new_scope);
-    return new_scope;
+    return Allocate<Scope>(this, parent_scope);
+}
+
+Environment* Cleaner::MakeEnvironment(Environment* parent, size_t slots_count) {
+    return AllocateSized<Environment>(Environment::AllocationSize(slots_count), parent, slots_count);
+}
+
+Symbol* Cleaner::Intern(std::string_view name) {
+    auto it = symbols_.find(name);
+    if (it != symbols_.end()) {
+        return it->second;
+    }
+    const auto& known = Symbol::kWellKnownNames;
+    auto known_it = std::find(std::begin(known), std::end(known), name);
+    uint32_t id = known_it != std::end(known) ? known_it - std::begin(known) : next_symbol_id_++;
+    Symbol* symbol = Allocate<Symbol>(std::string(name), id);
+    symbols_.emplace(symbol->GetName(), symbol);
+    young_symbols_.push_back(symbol);
+    if (id < Symbol::kFirstFreeId) {
+        AddRoot(symbol);
+    }
+    return symbol;
 }
 
 void Cleaner::Mark(MemoryNode* main_scope) {
-    main_scope->SetMark();
+    Visit(main_scope);
+    MarkRoots();
+    if (young_only_) {
+        for (MemoryNode* holder : remembered_) {
+            holder->Trace(this);
+        }
+    }
+    DrainMarkStack();
+    while (mark_stack_overflowed_) {
+        RescanMarked();
+    }
+}
+
+void Cleaner::MarkRoots() {
+    for (MemoryNode* root : roots_) {
+        Visit(root);
+    }
+    for (RootSet* roots : root_sets_) {
+        roots->TraceRoots(this);
+    }
 }
 
-void Cleaner::UnmarkAll() {
-    for (auto& obj : nodes_) {
-        if (obj == nullptr) {
-            continue;
+void Cleaner::Visit(MemoryNode* node) {
+    if (node == nullptr || IsImmediate(node) || node->marked_ || (young_only_ && node->old_)) {
+        return;
+    }
+    node->marked_ = true;
+    if (mark_stack_.size() >= mark_stack_limit_) {
+        mark_stack_overflowed_ = true;
+        return;
+    }
+    mark_stack_.push_back(node);
+}
+
+void Cleaner::DrainMarkStack() {
+    while (!mark_stack_.empty()) {
+        MemoryNode* node = mark_stack_.back();
+        mark_stack_.pop_back();
+        node->Trace(this);
+    }
+}
+
+void Cleaner::RescanMarked() {
+    mark_stack_overflowed_ = false;
+    auto rescan = [this](MemoryNode* node) {
+        if (node->marked_) {
+            node->Trace(this);
+            DrainMarkStack();
         }
-        obj->ResetMark();
+    };
+    if (young_only_) {
+        for (MemoryNode* node : young_nodes_) {
+            rescan(node);
+        }
+    } else {
+        allocator_.ForEachLive([&rescan](void* slot) {
+            rescan(static_cast<MemoryNode*>(slot));
+        });
     }
 }
 
+void Cleaner::AddRoot(MemoryNode* node) {
+    roots_.push_back(node);
+}
+
+void Cleaner::RemoveRoot(MemoryNode* node) {
+    std::erase(roots_, node);
+}
+
+void Cleaner::AddRootSet(RootSet* roots) {
+    root_sets_.push_back(roots);
+}
+
+void Cleaner::RemoveRootSet(RootSet* roots) {
+    std::erase(root_sets_, roots);
+}
+
+size_t Cleaner::HeapSize() const {
+    return allocator_.LiveCount();
+}
+
+size_t Cleaner::CollectionsCount() const {
+    return collections_count_;
+}
+
+size_t Cleaner::MinorCollectionsCount() const {
+    return minor_collections_count_;
+}
+
 void Cleaner::DeleteAll() {
-    for (auto& obj : nodes_) {
-        delete obj;
-    }
-}
\ No newline at end of file
+    allocator_.ForEachLive([](void* slot) {
+        static_cast<MemoryNode*>(slot)->~MemoryNode();
+    });
+    allocator_.Release();
+    young_nodes_.clear();
+    remembered_.clear();
+    roots_.clear();
+    symbols_.clear();
+    young_symbols_.clear();
+    next_symbol_id_ = Symbol::kFirstFreeId;
+}
@@ -0,0 +1,176 @@
+#include "node.h"
+#include <utility>
+#include "error.h"
+
+void Node::CompileTail(Compiler* compiler) {
+    Compile(compiler);
+    compiler->Emit(Opcode::RETURN);
+}
+
+ConstantNode::ConstantNode(Object* value) : value_(value) {}
+
+void ConstantNode::Compile(Compiler* compiler) {
+    compiler->Emit(Opcode::CONST, compiler->AddObject(value_));
+}
+
+void ConstantNode::Trace(Cleaner* cleaner) {
+    cleaner->Visit(value_);
+}
+
+LocalRefNode::LocalRefNode(uint32_t depth, uint32_t slot) : depth_(depth), slot_(slot) {}
+
+void LocalRefNode::Compile(Compiler* compiler) {
+    if (depth_ == 0) {
+        compiler->Emit(Opcode::LOCAL0, slot_);
+    } else {
+        compiler->Emit(Opcode::LOCAL, slot_);
+        compiler->EmitWord(depth_);
+    }
+}
+
+GlobalRefNode::GlobalRefNode(Symbol* name) : name_(name) {}
+
+void GlobalRefNode::Compile(Compiler* compiler) {
+    compiler->Emit(Opcode::GLOBAL, compiler->AddObject(name_));
+}
+
+Symbol* GlobalRefNode::GlobalName() {
+    return name_;
+}
+
+void GlobalRefNode::Trace(Cleaner* cleaner) {
+    cleaner->Visit(name_);
+}
+
+SetLocalNode::SetLocalNode(uint32_t depth, uint32_t slot, Node* value)
+    : depth_(depth), slot_(slot), value_(value) {}
+
+void SetLocalNode::Compile(Compiler* compiler) {
+    value_->Compile(compiler);
+    if (depth_ == 0) {
+        compiler->Emit(Opcode::SET_LOCAL0, slot_);
+    } else {
+        compiler->Emit(Opcode::SET_LOCAL, slot_);
+        compiler->EmitWord(depth_);
+    }
+}
+
+void SetLocalNode::Trace(Cleaner* cleaner) {
+    cleaner->Visit(value_);
+}
+
+SetGlobalNode::SetGlobalNode(Symbol* name, Node* value, bool is_define)
+    : name_(name), value_(value), is_define_(is_define) {}
+
+void SetGlobalNode::Compile(Compiler* compiler) {
+    value_->Compile(compiler);
+    compiler->Emit(is_define_ ? Opcode::DEFINE_GLOBAL : Opcode::SET_GLOBAL,
+                   compiler->AddObject(name_));
+}
+
+void SetGlobalNode::Trace(Cleaner* cleaner) {
+    cleaner->Visit(name_);
+    cleaner->Visit(value_);
+}
+
+IfNode::IfNode(Node* condition, Node* true_branch, Node* false_branch)
+    : condition_(condition), true_branch_(true_branch), false_branch_(false_branch) {}
+
+void IfNode::Compile(Compiler* compiler) {
+    condition_->Compile(compiler);
+    size_t to_false_branch = compiler->EmitJump(Opcode::JUMP_IF_FALSE);
+    true_branch_->Compile(compiler);
+    size_t to_end = compiler->EmitJump(Opcode::JUMP);
+    compiler->PatchJump(to_false_branch);
+    if (false_branch_ != nullptr) {
+        false_branch_->Compile(compiler);
+    } else {
+        compiler->Emit(Opcode::CONST, compiler->AddObject(nullptr));
+    }
+    compiler->PatchJump(to_end);
+}
+
+void IfNode::CompileTail(Compiler* compiler) {
+    condition_->Compile(compiler);
+    size_t to_false_branch = compiler->EmitJump(Opcode::JUMP_IF_FALSE);
+    true_branch_->CompileTail(compiler);
+    compiler->PatchJump(to_false_branch);
+    if (false_branch_ != nullptr) {
+        false_branch_->CompileTail(compiler);
+    } else {
+        compiler->Emit(Opcode::CONST, compiler->AddObject(nullptr));
+        compiler->Emit(Opcode::RETURN);
+    }
+}
+
+void IfNode::Trace(Cleaner* cleaner) {
+    cleaner->Visit(condition_);
+    cleaner->Visit(true_branch_);
+    cleaner->Visit(false_branch_);
+}
+
+LambdaNode::LambdaNode(size_t args_count, std::vector<Symbol*> locals, std::vector<Node*> body)
+    : args_count_(args_count), locals_(std::move(locals)), body_(std::move(body)), bytecode_(nullptr) {}
+
+void LambdaNode::Compile(Compiler* compiler) {
+    compiler->Emit(Opcode::CLOSURE, compiler->AddLambda(this));
+}
+
+Code* LambdaNode::GetBytecode(Cleaner* cleaner) {
+    if (bytecode_ == nullptr) {
+        bytecode_ = CompileBody(body_, cleaner);
+        cleaner->WriteBarrier(this, bytecode_);
+    }
+    return bytecode_;
+}
+
+void LambdaNode::Trace(Cleaner* cleaner) {
+    for (Symbol* local : locals_) {
+        cleaner->Visit(local);
+    }
+    for (Node* node : body_) {
+        cleaner->Visit(node);
+    }
+    cleaner->Visit(bytecode_);
+}
+
+CallNode::CallNode(Node* callee, std::vector<Node*> args)
+    : callee_(callee), args_(std::move(args)) {}
+
+void CallNode::Compile(Compiler* compiler) {
+    if (CompileOperands(compiler)) {
+        compiler->Emit(Opcode::CALL, static_cast<uint32_t>(args_.size()));
+    }
+}
+
+void CallNode::CompileTail(Compiler* compiler) {
+    if (CompileOperands(compiler)) {
+        compiler->Emit(Opcode::TAIL_CALL, static_cast<uint32_t>(args_.size()));
+    } else {
+        compiler->Emit(Opcode::RETURN);
+    }
+}
+
+bool CallNode::CompileOperands(Compiler* compiler) {
+    Symbol* name = callee_->GlobalName();
+    Opcode op;
+    if (name != nullptr && FindBuiltinOpcode(name, args_.size(), &op)) {
+        for (Node* arg : args_) {
+            arg->Compile(compiler);
+        }
+        compiler->Emit(op, compiler->AddObject(name));
+        return false;
+    }
+    callee_->Compile(compiler);
+    for (Node* arg : args_) {
+        arg->Compile(compiler);
+    }
+    return true;
+}
+
+void CallNode::Trace(Cleaner* cleaner) {
+    cleaner->Visit(callee_);
+    for (Node* arg : args_) {
+        cleaner->Visit(arg);
+    }
+}
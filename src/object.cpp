@@ -1,9 +1,11 @@
 #include "object.h"
+#include <algorithm>
 #include <string>
 #include "memory_node.h"
+#include "node.h"
 #include "ops.h"
 
-Object* FindElemInScope(const std::string& name, Scope* scope) {
+Object* FindElemInScope(Symbol* name, Scope* scope) {
     while (scope != nullptr) {
         if (scope->IsInScope(name)) {
             return scope->RetObj(name);
@@ -13,7 +15,7 @@ Object* FindElemInScope(const std::string& name, Scope* scope) {
     throw NameError("No such name exists");
 }
 
-Scope* FindScope(const std::string& name, Scope* scope) {
+Scope* FindScope(Symbol* name, Scope* scope) {
     while (scope != nullptr) {
     if (scope->IsInScope(name)) {
         return scope;
@@ -23,124 +25,153 @@ Scope* FindScope(const std::string& name, Scope* scope) {
     throw NameError("No such name found in scopes");
 }
 
-Scope::Scope() {
-    AddName("+", Cleaner::kCleaner->Make<OpHolder<Add>>());
-    AddName("-", Cleaner::kCleaner->Make<OpHolder<Sub>>());
-    AddName("*", Cleaner::kCleaner->Make<OpHolder<Mul>>());
-    AddName("/", Cleaner::kCleaner->Make<OpHolder<Div>>());
-    AddName("=", Cleaner::kCleaner->Make<OpHolder<Eq>>());
-    AddName(">", Cleaner::kCleaner->Make<OpHolder<Greater>>());
-    AddName("<", Cleaner::kCleaner->Make<OpHolder<Less>>());
-    AddName("<=", Cleaner::kCleaner->Make<OpHolder<LessOrEq>>());
-    AddName(">=", Cleaner::kCleaner->Make<OpHolder<GreaterOrEq>>());
-    AddName("min", Cleaner::kCleaner->Make<OpHolder<Min>>());
-    AddName("max", Cleaner::kCleaner->Make<OpHolder<Max>>());
-    AddName("abs", Cleaner::kCleaner->Make<OpHolder<Abs>>());
-    AddName("number?", Cleaner::kCleaner->Make<OpHolder<IsNumber>>());
-    AddName("quote", Cleaner::kCleaner->Make<OpHolder<Quote>>());
-    AddName("boolean?", Cleaner::kCleaner->Make<OpHolder<IsBool>>());
-    AddName("not", Cleaner::kCleaner->Make<OpHolder<Not>>());
-    AddName("and", Cleaner::kCleaner->Make<OpHolder<And>>());
-    AddName("or", Cleaner::kCleaner->Make<OpHolder<Or>>());
-    AddName("pair?", Cleaner::kCleaner->Make<OpHolder<Pair>>());
-    AddName("null?", Cleaner::kCleaner->Make<OpHolder<IsNull>>());
-    AddName("list?", Cleaner::kCleaner->Make<OpHolder<List>>());
-    AddName("cons", Cleaner::kCleaner->Make<OpHolder<Cons>>());
-    AddName("car", Cleaner::kCleaner->Make<OpHolder<Car>>());
-    AddName("cdr", Cleaner::kCleaner->Make<OpHolder<Cdr>>());
-    AddName("list", Cleaner::kCleaner->Make<OpHolder<ConstructList>>());
-    AddName("list-ref", Cleaner::kCleaner->Make<OpHolder<ListRef>>());
-    AddName("list-tail", Cleaner::kCleaner->Make<OpHolder<ListTail>>());
-    AddName("define", Cleaner::kCleaner->Make<OpHolder<Define>>());
-    AddName("lambda", Cleaner::kCleaner->Make<OpHolder<LambdaScheme>>());
-    AddName("set!", Cleaner::kCleaner->Make<OpHolder<Set>>());
-    AddName("if", Cleaner::kCleaner->Make<OpHolder<IfStatement>>());
-    AddName("symbol?", Cleaner::kCleaner->Make<OpHolder<IsSymbol>>());
-    AddName("set-car!", Cleaner::kCleaner->Make<OpHolder<SetCar>>());
-    AddName("set-cdr!", Cleaner::kCleaner->Make<OpHolder<SetCdr>>());
-}
-
-Scope::Scope(Scope* parent_scope) : parent_scope_(parent_scope) {
-    AddDependency(parent_scope);
-}
-
-bool Scope::IsInScope(const std::string& name) {
+Scope::Scope(Cleaner* cleaner) : cleaner_(cleaner), parent_scope_(nullptr) {
+    AddName(cleaner_->Intern("+"), cleaner_->Make<OpHolder<Add>>());
+    AddName(cleaner_->Intern("-"), cleaner_->Make<OpHolder<Sub>>());
+    AddName(cleaner_->Intern("*"), cleaner_->Make<OpHolder<Mul>>());
+    AddName(cleaner_->Intern("/"), cleaner_->Make<OpHolder<Div>>());
+    AddName(cleaner_->Intern("="), cleaner_->Make<OpHolder<Eq>>());
+    AddName(cleaner_->Intern(">"), cleaner_->Make<OpHolder<Greater>>());
+    AddName(cleaner_->Intern("<"), cleaner_->Make<OpHolder<Less>>());
+    AddName(cleaner_->Intern("<="), cleaner_->Make<OpHolder<LessOrEq>>());
+    AddName(cleaner_->Intern(">="), cleaner_->Make<OpHolder<GreaterOrEq>>());
+    AddName(cleaner_->Intern("min"), cleaner_->Make<OpHolder<Min>>());
+    AddName(cleaner_->Intern("max"), cleaner_->Make<OpHolder<Max>>());
+    AddName(cleaner_->Intern("abs"), cleaner_->Make<BaseOpHolder>(&Abs));
+    AddName(cleaner_->Intern("number?"), cleaner_->Make<BaseOpHolder>(&IsNumber));
+    AddName(cleaner_->Intern("boolean?"), cleaner_->Make<BaseOpHolder>(&IsBool));
+    AddName(cleaner_->Intern("not"), cleaner_->Make<BaseOpHolder>(&Not));
+    AddName(cleaner_->Intern("pair?"), cleaner_->Make<BaseOpHolder>(&Pair));
+    AddName(cleaner_->Intern("null?"), cleaner_->Make<BaseOpHolder>(&IsNull));
+    AddName(cleaner_->Intern("list?"), cleaner_->Make<BaseOpHolder>(&List));
+    AddName(cleaner_->Intern("cons"), cleaner_->Make<BaseOpHolder>(&Cons));
+    AddName(cleaner_->Intern("car"), cleaner_->Make<BaseOpHolder>(&Car));
+    AddName(cleaner_->Intern("cdr"), cleaner_->Make<BaseOpHolder>(&Cdr));
+    AddName(cleaner_->Intern("list"), cleaner_->Make<OpHolder<ConstructList>>());
+    AddName(cleaner_->Intern("list-ref"), cleaner_->Make<BaseOpHolder>(&ListRef));
+    AddName(cleaner_->Intern("list-tail"), cleaner_->Make<BaseOpHolder>(&ListTail));
+    AddName(cleaner_->Intern("symbol?"), cleaner_->Make<BaseOpHolder>(&IsSymbol));
+    AddName(cleaner_->Intern("set-car!"), cleaner_->Make<BaseOpHolder>(&SetCar));
+    AddName(cleaner_->Intern("set-cdr!"), cleaner_->Make<BaseOpHolder>(&SetCdr));
+    AddName(cleaner_->Intern("vector?"), cleaner_->Make<BaseOpHolder>(&IsVector));
+    AddName(cleaner_->Intern("make-vector"), cleaner_->Make<OpHolder<MakeVector>>());
+    AddName(cleaner_->Intern("vector"), cleaner_->Make<OpHolder<ConstructVector>>());
+    AddName(cleaner_->Intern("vector-length"), cleaner_->Make<BaseOpHolder>(&VectorLength));
+    AddName(cleaner_->Intern("vector-ref"), cleaner_->Make<BaseOpHolder>(&VectorRef));
+    AddName(cleaner_->Intern("vector-set!"), cleaner_->Make<BaseOpHolder>(&VectorSet));
+    AddName(cleaner_->Intern("vector-fill!"), cleaner_->Make<BaseOpHolder>(&VectorFill));
+    AddName(cleaner_->Intern("vector->list"), cleaner_->Make<BaseOpHolder>(&VectorToList));
+    AddName(cleaner_->Intern("list->vector"), cleaner_->Make<BaseOpHolder>(&ListToVector));
+    AddName(cleaner_->Intern("hash-table?"), cleaner_->Make<BaseOpHolder>(&IsHashTable));
+    AddName(cleaner_->Intern("make-hash-table"), cleaner_->Make<BaseOpHolder>(&MakeHashTable));
+    AddName(cleaner_->Intern("hash-table-ref"), cleaner_->Make<OpHolder<HashTableRef>>());
+    AddName(cleaner_->Intern("hash-table-set!"), cleaner_->Make<BaseOpHolder>(&HashTableSet));
+    AddName(cleaner_->Intern("hash-table-delete!"), cleaner_->Make<BaseOpHolder>(&HashTableDelete));
+    AddName(cleaner_->Intern("hash-table-count"), cleaner_->Make<BaseOpHolder>(&HashTableCount));
+    AddName(cleaner_->Intern("hash-table->alist"), cleaner_->Make<BaseOpHolder>(&HashTableToAlist));
+}
+
+Scope::Scope(Cleaner* cleaner, Scope* parent_scope) : cleaner_(cleaner), parent_scope_(parent_scope) {}
+
+bool Scope::IsInScope(Symbol* name) {
     return scope_map_.contains(name);
 }
 
- Object* Scope::RetObj(const std::string& name) {
+ Object* Scope::RetObj(Symbol* name) {
     return scope_map_[name];
  }
 
+Object** Scope::FindBinding(Symbol* name) {
+    auto it = scope_map_.find(name);
+    return it == scope_map_.end() ? nullptr : &it->second;
+}
+
 Scope* Scope::RetParentScope() {
     return parent_scope_;
 }
 
-void Scope::AddName(const std::string& name, Object* obj) {
-    if (IsInScope(name)) {
-        RemoveDependency(scope_map_[name]);
-    }
+Cleaner* Scope::GetCleaner() {
+    return cleaner_;
+}
+
+void Scope::AddName(Symbol* name, Object* obj) {
     scope_map_[name] = obj;
-    AddDependency(obj);
+    cleaner_->WriteBarrier(this, name);
+    cleaner_->WriteBarrier(this, obj);
+}
+
+void Scope::Trace(Cleaner* cleaner) {
+    cleaner->Visit(parent_scope_);
+    for (const auto& [name, obj] : scope_map_) {
+        cleaner->Visit(name);
+        cleaner->Visit(obj);
+    }
 }
 
-Number::Number(int val) : val_(val) {}
+const size_t Environment::kInlineSlots =
+    (SlabAllocator::kMaxSlotSize - sizeof(Environment)) / sizeof(Object*);
 
-Object* Number::Exec(Scope* scope) { //NOLINT
-    return this;
+Environment::Environment(Environment* parent, size_t slots_count)
+    : parent_(parent), slots_count_(slots_count) {
+    if (slots_count <= kInlineSlots) {
+        slots_ = reinterpret_cast<Object**>(this + 1);
+        std::fill_n(slots_, slots_count, nullptr);
+    } else {
+        slots_ = new Object*[slots_count]();
+    }
 }
-std::string Number::Format() {
-    return std::to_string(val_);
+
+Environment::~Environment() {
+    if (slots_count_ > kInlineSlots) {
+        delete[] slots_;
+    }
 }
-int Number::GetValue() const {
-    return val_;
+
+size_t Environment::AllocationSize(size_t slots_count) {
+    if (slots_count > kInlineSlots) {
+        return sizeof(Environment);
+    }
+    return sizeof(Environment) + slots_count * sizeof(Object*);
 }
 
-Symbol::Symbol(const std::string& val) : val_(val) {}
-Object* Symbol::Exec(Scope* scope) {
-    if (val_ == "#t" || val_ == "#f") {
-        return this;
+void Environment::SetSlot(size_t slot, Object* obj, Cleaner* cleaner) {
+    slots_[slot] = obj;
+    cleaner->WriteBarrier(this, obj);
+}
+
+void Environment::Trace(Cleaner* cleaner) {
+    cleaner->Visit(parent_);
+    for (size_t i = 0; i < slots_count_; ++i) {
+        cleaner->Visit(slots_[i]);
+    }
+}
+
+std::string FormatObject(Object* obj) {
+    if (obj == nullptr) {
+        return "()";
+    }
+    if (Is<Number>(obj)) {
+        return std::to_string(GetNumber(obj));
+    }
+    if (Is<Boolean>(obj)) {
+        return IsFalse(obj) ? "#f" : "#t";
     }
-    auto val = FindElemInScope(val_, scope);
-    return val;
+    return obj->Format();
 }
+
+Symbol::Symbol(std::string val, uint32_t id) : Object(ObjectType::SYMBOL), val_(std::move(val)), id_(id) {}
 std::string Symbol::Format() {
     return val_;
 }
 const std::string& Symbol::GetName() const {
     return val_;
 }
-
-Cell::Cell(Object* first, Object* second) : first_(first), second_(second) {
-    AddDependency(first);
-    AddDependency(second);
+uint32_t Symbol::GetId() const {
+    return id_;
 }
 
-Object* Cell::Exec(Scope* scope) {
-    
-    if (Is<Symbol>(first_)) {
-        if (!CheckIfCellIsValid(As<Cell>(this))) {
-            throw RuntimeError("Cell structure is not valid");
-        }
-        std::string op_signature = As<Symbol>(first_)->GetName();
-        auto scheme = FindElemInScope(op_signature, scope);
-        if (Is<LambdaScheme>(scheme)) {
-            auto lambda_func = LambdaFunction(As<LambdaScheme>(scheme), second_, scope);
-            return lambda_func.PerformOnArgs();
-        } else if (Is<BaseOpHolder>(scheme)) {
-            return As<BaseOpHolder>(scheme)->MakeOp(second_, scope);
-        }
-        throw SyntaxError("Invalid syntax for executed cell");
-    } else if (Is<Cell>(first_)) {
-        auto lambda_scheme = first_->Exec(scope);
-        if (!Is<LambdaScheme>(lambda_scheme)) {
-            throw SyntaxError("Bad syntax for executed cell");
-        }
-        LambdaFunction lambda_func(As<LambdaScheme>(lambda_scheme), second_, scope);
-        return lambda_func.PerformOnArgs();
-    }
-    throw RuntimeError("Can't execute cell");
-}
+Cell::Cell(Object* first, Object* second)
+    : Object(ObjectType::CELL), first_(first), second_(second) {}
 
 Object* Cell::GetFirst() const {
     return first_;
@@ -157,13 +188,7 @@ std::string Cell::Format() {
         auto current_obj = As<Cell>(cell_iter)->GetFirst();
         auto next_obj = As<Cell>(cell_iter)->GetSecond();
 
-        std::string current_obj_format;
-        if (current_obj == nullptr) {
-            current_obj_format = "()";
-        } else {
-            current_obj_format = current_obj->Format();
-        }
-        formatted_cell += current_obj_format + " ";
+        formatted_cell += FormatObject(current_obj) + " ";
                 if (!Is<Cell>(next_obj) && next_obj != nullptr) {
             formatted_cell += ". ";
         }
@@ -171,153 +196,83 @@ std::string Cell::Format() {
         cell_iter = next_obj;
     }
     if (cell_iter != nullptr) {
-        formatted_cell += cell_iter->Format() + " ";
+        formatted_cell += FormatObject(cell_iter) + " ";
     }
 
     formatted_cell.pop_back();
     return formatted_cell + ")";
 }
 
-void Cell::SetFirst(Object* obj) {
-    RemoveDependency(first_);
+void Cell::SetFirst(Object* obj, Cleaner* cleaner) {
     first_ = obj;
-    AddDependency(first_);
+    cleaner->WriteBarrier(this, obj);
 }
 
-void Cell::SetSecond(Object* obj) {
-    RemoveDependency(second_);
+void Cell::SetSecond(Object* obj, Cleaner* cleaner) {
     second_ = obj;
-    AddDependency(second_);
+    cleaner->WriteBarrier(this, obj);
 }
 
-void Cell::SetName(const std::string& name) {
-    Object* set_name = Cleaner::kCleaner->Make<Symbol>(name);
-    AddDependency(set_name);
-    name_ = set_name;
+void Cell::Trace(Cleaner* cleaner) {
+    cleaner->Visit(first_);
+    cleaner->Visit(second_);
 }
 
-Object* Cell::GetName() {
-    return name_;
-}
+Vector::Vector(size_t size, Object* fill) : Object(ObjectType::VECTOR), elements_(size, fill) {}
 
-LambdaScheme::LambdaScheme(Object* arg, Scope* scope, bool is_sugar,  
-    bool is_context_capturer) : is_context_capturer_(is_context_capturer) {
-    if (!Is<Cell>(arg)) {
-            ThrowSyntax();
-        }
-        Object* lambda_args = As<Cell>(arg)->GetFirst();
-        if (!Is<Cell>(lambda_args) && lambda_args != nullptr) {
-            ThrowSyntax();
-        }
-        if (is_sugar) {
-            auto symb = As<Cell>(lambda_args)->GetFirst();
-            if (!Is<Symbol>(symb)) {
-                ThrowSyntax();
-            }
-            lambda_args = As<Cell>(lambda_args)->GetSecond();
-            name_ = As<Symbol>(symb)->GetName();
-        }
-        while (lambda_args != nullptr) {
-            auto symb = As<Cell>(lambda_args)->GetFirst();
-            if (!Is<Symbol>(symb)) {
-                ThrowSyntax();
-            }
-            lambda_args_.push_back(As<Symbol>(symb)->GetName());
-            lambda_args = As<Cell>(lambda_args)->GetSecond();
-        }
-        arg = As<Cell>(arg)->GetSecond();
-        if (!Is<Cell>(arg)) {
-            ThrowSyntax();
-        }
-        auto body = arg;
-        if (!Is<Cell>(body)) {
-            ThrowSyntax();
-        }
-        while (body != nullptr) {
-            auto func = As<Cell>(body)->GetFirst();
-            AddDependency(func);
-            functions_.push_back(As<Cell>(body)->GetFirst());
-            body = As<Cell>(body)->GetSecond();
-        }
+Vector::Vector(std::vector<Object*> elements)
+    : Object(ObjectType::VECTOR), elements_(std::move(elements)) {}
 
-        if (is_context_capturer_ || lambda_args_.empty()) {
-            scope_ = scope;
-            is_context_capturer_ = true;
+std::string Vector::Format() {
+    std::string formatted_vector("#(");
+    for (size_t i = 0; i < elements_.size(); ++i) {
+        if (i != 0) {
+            formatted_vector += " ";
         }
+        formatted_vector += FormatObject(elements_[i]);
+    }
+    return formatted_vector + ")";
+}
 
-        if (is_context_capturer_) {
-            AddDependency(scope);
-        }
+void Vector::Set(size_t index, Object* obj, Cleaner* cleaner) {
+    elements_[index] = obj;
+    cleaner->WriteBarrier(this, obj);
 }
 
-bool LambdaScheme::IsCC() {
-    return is_context_capturer_;
+void Vector::Fill(Object* obj, Cleaner* cleaner) {
+    std::fill(elements_.begin(), elements_.end(), obj);
+    cleaner->WriteBarrier(this, obj);
 }
 
-const std::vector<std::string>& LambdaScheme::ReturnArgs() const {
-    return lambda_args_;
+void Vector::Trace(Cleaner* cleaner) {
+    for (Object* obj : elements_) {
+        cleaner->Visit(obj);
+    }
 }
 
-const std::vector<Object*> LambdaScheme::ReturnFuncs() const {
-    return functions_;
+LambdaScheme::LambdaScheme(LambdaNode* code, Environment* env)
+    : Object(ObjectType::LAMBDA_SCHEME), code_(code), env_(env) {}
+
+LambdaNode* LambdaScheme::GetCode() {
+    return code_;
 }
 
-std::string& LambdaScheme::GetName() {
-    return name_;
+Environment* LambdaScheme::GetClosureEnv() {
+    return env_;
 }
 
-Scope* LambdaScheme::GetCCScope() {
-    return scope_;
+void LambdaScheme::Trace(Cleaner* cleaner) {
+    cleaner->Visit(code_);
+    cleaner->Visit(env_);
 }
 
 std::string LambdaScheme::Format() {
     throw RuntimeError("Kostyl");
 }
 
-Object* LambdaScheme::Exec(Scope* scope) {
-    if (scope_ != nullptr) {
-        scope = scope_;
-    }
-    if (lambda_args_.empty()) {
-        Object* value;
-        for (auto& function : functions_) {
-            value = function->Exec(scope);
-        }
-        return value;
-    }
-    throw RuntimeError("Something went wrong in the internal logic :()");
-}
-
 template <typename F>
-requires std::is_base_of_v<Operation, F> || std::is_same_v<LambdaScheme, F>
-
-Object* OpHolder<F>::MakeOp(Object* arg_obj, Scope* scope) {
-    return F(arg_obj, scope).PerformOnArgs();
-}
+requires std::is_base_of_v<Operation, F>
 
-template<>
-Object* OpHolder<Quote>::MakeOp(Object* arg_obj, Scope* scope) { //NOLINT
-    return Quote(arg_obj).PerformOnArgs();
+Object* OpHolder<F>::Run(Arguments arguments, Cleaner* cleaner) {
+    return F(arguments, cleaner).PerformOnArgs();
 }
-
-template<>
-Object* OpHolder<LambdaScheme>::MakeOp(Object* arg_obj, Scope* scope) {
-    auto scheme = Cleaner::kCleaner->Make<LambdaScheme>(arg_obj, scope);
-    return scheme;
-}
-
-bool CheckIfCellIsValid(Cell* cell) {
-    if (!Is<Symbol>(cell->GetFirst())) {
-        return false;
-    }
-    Object* current_obj = cell;
-    while (Is<Cell>(current_obj)) {
-        current_obj = As<Cell>(current_obj)->GetSecond();
-    }
-    return current_obj == nullptr;
-}
-
-Object* ConstructBool(bool val) {
-    std::string bool_literal = val ? "#t" : "#f";
-    return Cleaner::kCleaner->Make<Symbol>(bool_literal);
-}
\ No newline at end of file
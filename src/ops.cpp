@@ -2,46 +2,21 @@
 #include <sys/types.h>
 #include <cstddef>
 #include <memory>
+#include <utility>
+#include <vector>
 #include "error.h"
+#include "hash_table.h"
 #include "memory_node.h"
 #include "object.h"
 
-Operation::Operation(Object* arg_obj, Scope* scope) : scope_(scope) {
-    if (arg_obj != nullptr && !Is<Cell>(arg_obj)) {
-        std::string what = (arg_obj == nullptr ? "()" : arg_obj->Format());
-        throw RuntimeError("Type of arguments of operation is not Cell: " + what);
-    }
-    
-    while (arg_obj != nullptr) {
-        Cell* cell_obj = As<Cell>(arg_obj);
-        Object* first_cell_arg = cell_obj->GetFirst();
-        Object* sec_cell_arg = cell_obj->GetSecond();
-        Object* obj_to_push = nullptr;
-        if (!first_cell_arg) {
-            obj_to_push = nullptr;
-        } else if (Is<Symbol>(first_cell_arg)) {
-            std::string symbol_val = As<Symbol>(first_cell_arg)->GetName();
-            if (symbol_val == "#t" || symbol_val == "#f") {
-                obj_to_push = first_cell_arg;
-            } else {
-                obj_to_push = FindElemInScope(symbol_val, scope);
-                if(Is<OpHolder<Quote>>(obj_to_push)) {
-                    obj_to_push = Quote(sec_cell_arg).PerformOnArgs();
-                    arg_obj = sec_cell_arg;
-                }
-            }
-        } else {
-            obj_to_push = first_cell_arg->Exec(scope);
-        }
-        arguments_.push_back(obj_to_push);
-        arg_obj = As<Cell>(arg_obj)->GetSecond();
-    }
-}
+Operation::Operation(Arguments arguments, Cleaner* cleaner)
+    : cleaner_(cleaner), arguments_(std::move(arguments)) {}
+
 Object* Operation::PerformOnArgs() {
     throw RuntimeError("Inevitable Kostyl :)");
 }
 
-ArithmeticModule::ArithmeticModule(Object* arg_obj, Scope* scope) : Operation(arg_obj, scope) {}
+ArithmeticModule::ArithmeticModule(Arguments arguments, Cleaner* cleaner) : Operation(std::move(arguments), cleaner) {}
 Object* ArithmeticModule::PerformArithmeticOp(ArithmeticModule::ArithmeticType type) {
     int val = 0;
     size_t iter = 0;
@@ -54,7 +29,7 @@ Object* ArithmeticModule::PerformArithmeticOp(ArithmeticModule::ArithmeticType t
         if (!Is<Number>(arguments_.front())) {
             throw RuntimeError("Invalid arguments for arithmetic operation");
         }
-        val = As<Number>(arguments_.front())->GetValue();
+        val = GetNumber(arguments_.front());
         iter = 1;
     }
     for (;iter < arguments_.size(); ++iter) {
@@ -62,7 +37,7 @@ Object* ArithmeticModule::PerformArithmeticOp(ArithmeticModule::ArithmeticType t
         if (!Is<Number>(current_arg)) {
             throw RuntimeError("Invalid arguments for arithmetic operation");
         }
-        int current_value = As<Number>(current_arg)->GetValue();
+        int current_value = GetNumber(current_arg);
         if (type == ArithmeticType::SUM) {
             val += current_value;
         } else if (type == ArithmeticType::SUB) {
@@ -73,30 +48,30 @@ Object* ArithmeticModule::PerformArithmeticOp(ArithmeticModule::ArithmeticType t
             val *= current_value;
         }
     }
-    return Cleaner::kCleaner->Make<Number>(val);
+    return MakeNumber(val);
 }
 
-Add::Add(Object* arg_obj, Scope* scope) : ArithmeticModule(arg_obj, scope) {}
+Add::Add(Arguments arguments, Cleaner* cleaner) : ArithmeticModule(std::move(arguments), cleaner) {}
 Object* Add::PerformOnArgs() {
     return PerformArithmeticOp(ArithmeticType::SUM);
 }
 
-Sub::Sub(Object* arg_obj, Scope* scope) : ArithmeticModule(arg_obj, scope) {}
+Sub::Sub(Arguments arguments, Cleaner* cleaner) : ArithmeticModule(std::move(arguments), cleaner) {}
 Object* Sub::PerformOnArgs() {
     return PerformArithmeticOp(ArithmeticType::SUB);
 }
 
-Mul::Mul(Object* arg_obj, Scope* scope) : ArithmeticModule(arg_obj, scope) {}
+Mul::Mul(Arguments arguments, Cleaner* cleaner) : ArithmeticModule(std::move(arguments), cleaner) {}
 Object* Mul::PerformOnArgs() {
     return PerformArithmeticOp(ArithmeticType::MUL);
 }
 
-Div::Div(Object* arg_obj, Scope* scope) : ArithmeticModule(arg_obj, scope) {}
+Div::Div(Arguments arguments, Cleaner* cleaner) : ArithmeticModule(std::move(arguments), cleaner) {}
 Object* Div::PerformOnArgs() {
     return PerformArithmeticOp(ArithmeticType::DIV);
 }
 
-CompareModule::CompareModule(Object* arg_obj, Scope* scope) : Operation(arg_obj, scope) {}
+CompareModule::CompareModule(Arguments arguments, Cleaner* cleaner) : Operation(std::move(arguments), cleaner) {}
 Object* CompareModule::Compare(CompareModule::CompareType type) {
     if (arguments_.empty()) {
         return ConstructBool(true);
@@ -105,13 +80,13 @@ Object* CompareModule::Compare(CompareModule::CompareType type) {
         throw RuntimeError("Invalid arguments for Compare operation");
     }
     bool answer = true;
-    int val = As<Number>(arguments_.front())->GetValue();
+    int val = GetNumber(arguments_.front());
     for (size_t i = 1; i < arguments_.size(); ++i) {
         Object* current_arg = arguments_[i];
         if (!Is<Number>(current_arg)) {
             throw RuntimeError("Invalid arguments for Compare operation");
         }
-        int current_val = As<Number>(current_arg)->GetValue();
+        int current_val = GetNumber(current_arg);
         bool result = false;
         if (type == CompareType::EQ) {
             result = (val == current_val);
@@ -132,32 +107,32 @@ Object* CompareModule::Compare(CompareModule::CompareType type) {
     return ConstructBool(answer);
 }
 
-Eq::Eq(Object* arg_obj, Scope* scope) : CompareModule(arg_obj, scope) {}
+Eq::Eq(Arguments arguments, Cleaner* cleaner) : CompareModule(std::move(arguments), cleaner) {}
 Object* Eq::PerformOnArgs() {
     return Compare(CompareType::EQ);
 }
 
-Greater::Greater(Object* arg_obj, Scope* scope) : CompareModule(arg_obj, scope) {}
+Greater::Greater(Arguments arguments, Cleaner* cleaner) : CompareModule(std::move(arguments), cleaner) {}
 Object* Greater::PerformOnArgs() {
     return Compare(CompareType::GREATER);
 }
 
-Less::Less(Object* arg_obj, Scope* scope) : CompareModule(arg_obj, scope) {}
+Less::Less(Arguments arguments, Cleaner* cleaner) : CompareModule(std::move(arguments), cleaner) {}
 Object* Less::PerformOnArgs() {
     return Compare(CompareType::LESS);
 }
 
-LessOrEq::LessOrEq(Object* arg_obj, Scope* scope) : CompareModule(arg_obj, scope) {}
+LessOrEq::LessOrEq(Arguments arguments, Cleaner* cleaner) : CompareModule(std::move(arguments), cleaner) {}
 Object* LessOrEq::PerformOnArgs() {
     return Compare(CompareType::EQLESS);
 }
 
-GreaterOrEq::GreaterOrEq(Object* arg_obj, Scope* scope) : CompareModule(arg_obj, scope) {}
+GreaterOrEq::GreaterOrEq(Arguments arguments, Cleaner* cleaner) : CompareModule(std::move(arguments), cleaner) {}
 Object* GreaterOrEq::PerformOnArgs() {
     return Compare(CompareType::EQGREATER);
 }
 
-Min::Min(Object* arg_obj, Scope* scope) : Operation(arg_obj, scope) {}
+Min::Min(Arguments arguments, Cleaner* cleaner) : Operation(std::move(arguments), cleaner) {}
 Object* Min::PerformOnArgs() {
     if (arguments_.empty()) {
         throw RuntimeError("Abscence of arguments for Min operation");
@@ -165,18 +140,18 @@ Object* Min::PerformOnArgs() {
     if (!Is<Number>(arguments_.front())) {
         throw RuntimeError("Invalid arguments for Min operation");
     }
-    int val = As<Number>(arguments_.front())->GetValue();
+    int val = GetNumber(arguments_.front());
     for (size_t i = 1; i < arguments_.size(); ++i) {
         Object* current_arg = arguments_[i];
         if (!Is<Number>(current_arg)) {
             throw RuntimeError("Invalid arguments for Min operation");
         }
-        val = std::min(As<Number>(current_arg)->GetValue(), val);
+        val = std::min(GetNumber(current_arg), val);
     }
-    return Cleaner::kCleaner->Make<Number>(val);
+    return MakeNumber(val);
 }
 
-Max::Max(Object* arg_obj, Scope* scope) : Operation(arg_obj, scope) {}
+Max::Max(Arguments arguments, Cleaner* cleaner) : Operation(std::move(arguments), cleaner) {}
 Object* Max::PerformOnArgs() {
     if (arguments_.empty()) {
         throw RuntimeError("Abscence of arguments for Max operation");
@@ -184,89 +159,70 @@ Object* Max::PerformOnArgs() {
     if (!Is<Number>(arguments_.front())) {
         throw RuntimeError("Invalid arguments for Max operation");
     }
-    int val = As<Number>(arguments_.front())->GetValue();
+    int val = GetNumber(arguments_.front());
     for (size_t i = 1; i < arguments_.size(); ++i) {
         Object* current_arg = arguments_[i];
         if (!Is<Number>(current_arg)) {
             throw RuntimeError("Invalid arguments for Max operation");
         }
-        val = std::max(As<Number>(current_arg)->GetValue(), val);
+        val = std::max(GetNumber(current_arg), val);
     }
-    return Cleaner::kCleaner->Make<Number>(val);
+    return MakeNumber(val);
 }
 
-Abs::Abs(Object* arg_obj, Scope* scope) : Operation(arg_obj, scope) {};
-Object* Abs::PerformOnArgs() {
-    if (arguments_.empty()) {
+namespace {
+
+template <class ObjectType>
+bool CheckType(BaseOpHolder::Arguments arguments) {
+    if (arguments.size() != 1) {
+        throw RuntimeError("Invalid arguments for IsType operation");
+    }
+    return Is<ObjectType>(arguments.front());
+}
+
+}  // namespace
+
+Object* Abs(BaseOpHolder::Arguments arguments, Cleaner*) {
+    if (arguments.empty()) {
         throw RuntimeError("Abscence of arguments for Abs operation");
     }
-    if (arguments_.size() > 1 || !Is<Number>(arguments_.front())) {
+    if (arguments.size() > 1 || !Is<Number>(arguments.front())) {
         throw RuntimeError("Invalid arguments for Abs operation");
     }
     
-    int val = As<Number>(arguments_.front())->GetValue();
-    return Cleaner::kCleaner->Make<Number>(std::abs(val));
+    int val = GetNumber(arguments.front());
+    return MakeNumber(std::abs(val));
 }
 
-IsNumber::IsNumber(Object* arg_obj, Scope* scope) : TypeChecker<Number>(arg_obj, scope) {}
-Object* IsNumber::PerformOnArgs() {
-    return ConstructBool(CheckType());
+Object* IsNumber(BaseOpHolder::Arguments arguments, Cleaner*) {
+    return ConstructBool(CheckType<Number>(arguments));
 }
 
-IsBool::IsBool(Object* arg_obj, Scope* scope) : TypeChecker<Symbol>(arg_obj, scope) {}
-Object* IsBool::PerformOnArgs() {
-    bool answer = CheckType();
-    if (answer) {
-        std::string symbol = As<Symbol>(arguments_.front())->GetName();
-        answer = (symbol == "#t") || (symbol == "#f");
-    }
-    return ConstructBool(answer);
+Object* IsBool(BaseOpHolder::Arguments arguments, Cleaner*) {
+    return ConstructBool(CheckType<Boolean>(arguments));
 }
 
-Not::Not(Object* arg_obj, Scope* scope) : Operation(arg_obj, scope) {}
-Object* Not::PerformOnArgs() {
-    if (arguments_.empty() || arguments_.size() > 1) {
+Object* Not(BaseOpHolder::Arguments arguments, Cleaner*) {
+    if (arguments.empty() || arguments.size() > 1) {
         throw RuntimeError("Invalid arguments for Not operation");
     }
-    bool answer = false;
-    if (Is<Symbol>(arguments_.front()) && (As<Symbol>(arguments_.front()))->GetName() == "#f") {
-        answer = true;
-    }
-    return ConstructBool(answer);
-}
-
-And::And(Object* arg_obj, Scope* scope) : LogicModule<false>(arg_obj, scope) {}
-Object* And::PerformOnArgs() {
-    if (last_evalulated_obj_ == nullptr) {
-        return ConstructBool(true);
-    }
-    return last_evalulated_obj_;
-}
-
-Or::Or(Object* arg_obj, Scope* scope) : LogicModule<true>(arg_obj, scope) {}
-Object* Or::PerformOnArgs() {
-    if (last_evalulated_obj_ == nullptr) {
-        return ConstructBool(false);
-    }
-    return last_evalulated_obj_;
+    return ConstructBool(IsFalse(arguments.front()));
 }
 
-IsNull::IsNull(Object* arg_obj, Scope* scope) : Operation(arg_obj, scope) {}
-Object* IsNull::PerformOnArgs() {
-    if (arguments_.empty() || arguments_.size() > 1) {
+Object* IsNull(BaseOpHolder::Arguments arguments, Cleaner*) {
+    if (arguments.empty() || arguments.size() > 1) {
         throw RuntimeError("Wrong arguments for IsNull operation");
     }
-    return ConstructBool(arguments_.front() == nullptr);
+    return ConstructBool(arguments.front() == nullptr);
 }
 
-Pair::Pair(Object* arg_obj, Scope* scope) : Operation(arg_obj, scope) {}
-Object* Pair::PerformOnArgs() {
-    if (arguments_.empty() || arguments_.size() > 1) {
+Object* Pair(BaseOpHolder::Arguments arguments, Cleaner*) {
+    if (arguments.empty() || arguments.size() > 1) {
         throw RuntimeError("Invalid arguments for IsPair operation");
     }
     bool answer = false;
-    if (Is<Cell>(arguments_.front())) {
-        auto arg_cell = As<Cell>(arguments_.front());
+    if (Is<Cell>(arguments.front())) {
+        auto arg_cell = As<Cell>(arguments.front());
         if (Is<Cell>(arg_cell->GetSecond())) {
             if (As<Cell>(arg_cell->GetSecond())->GetSecond() == nullptr) {
                 answer = true;
@@ -278,407 +234,262 @@ Object* Pair::PerformOnArgs() {
     return ConstructBool(answer);
 }
 
-List::List(Object* arg_obj, Scope* scope) : Operation(arg_obj, scope) {}
-Object* List::PerformOnArgs() {
-    if (arguments_.empty() || arguments_.size() > 1) {
+Object* List(BaseOpHolder::Arguments arguments, Cleaner*) {
+    if (arguments.empty() || arguments.size() > 1) {
         throw RuntimeError("Invalid arguments for IsList operation");
     }
-    Object* list_iter = arguments_.front();
+    Object* list_iter = arguments.front();
     while (Is<Cell>(list_iter)) {
         list_iter = As<Cell>(list_iter)->GetSecond();
     }
     return ConstructBool(list_iter == nullptr);
 }
 
-Cons::Cons(Object* arg_obj, Scope* scope) : Operation(arg_obj, scope) {}
-Object* Cons::PerformOnArgs() {
-    if (arguments_.size() != 2) {
+Object* Cons(BaseOpHolder::Arguments arguments, Cleaner* cleaner) {
+    if (arguments.size() != 2) {
         throw RuntimeError("Invalid arguments for Cons operation");
     }
-    return Cleaner::kCleaner->Make<Cell>(arguments_[0], arguments_[1]);
+    return cleaner->Make<Cell>(arguments[0], arguments[1]);
 }
 
-Car::Car(Object* arg_obj, Scope* scope) : Operation(arg_obj, scope) {}
-Object* Car::PerformOnArgs() {
-    if ((arguments_.size() != 1) || !Is<Cell>(arguments_.front())) {
+Object* Car(BaseOpHolder::Arguments arguments, Cleaner*) {
+    if ((arguments.size() != 1) || !Is<Cell>(arguments.front())) {
         throw RuntimeError("Invalid arguments for Car operation");
     }
-    return As<Cell>(arguments_.front())->GetFirst();
+    return As<Cell>(arguments.front())->GetFirst();
 }
 
-Cdr::Cdr(Object* arg_obj, Scope* scope) : Operation(arg_obj, scope) {}
-Object* Cdr::PerformOnArgs() {
-    if ((arguments_.size() != 1) || !Is<Cell>(arguments_.front())) {
+Object* Cdr(BaseOpHolder::Arguments arguments, Cleaner*) {
+    if ((arguments.size() != 1) || !Is<Cell>(arguments.front())) {
         throw RuntimeError("Invalid arguments for Cdr operation");
     }
-    Arguments list_elements;
-    Object* list_iter = arguments_.front();
-    if (!Is<Cell>(list_iter)) {
-        throw RuntimeError("Bad args for Cdr");
-    }
-    if (QCheckIsPair(list_iter)) {
-        return As<Cell>(list_iter)->GetSecond();
-    }
-    while (Is<Cell>(list_iter)) {
-        list_elements.push_back(As<Cell>(list_iter)->GetFirst());
-        list_iter = As<Cell>(list_iter)->GetSecond();
-    }
-    if (list_iter != nullptr) {
-        list_elements.push_back(list_iter);
-    }
-    if (list_elements.size() == 1) {
-        return nullptr;
-    }
-    return (list_iter == nullptr) ? Operation::MakeList<true>(list_elements, 1) :
-                                    Operation::MakeList<false>(list_elements, 1);
+    return As<Cell>(arguments.front())->GetSecond();
 }
 
-ConstructList::ConstructList(Object* arg_obj, Scope* scope) : Operation(arg_obj, scope) {}
+ConstructList::ConstructList(Arguments arguments, Cleaner* cleaner) : Operation(std::move(arguments), cleaner) {}
 Object* ConstructList::PerformOnArgs() {
-    return Operation::MakeList<true>(arguments_, 0);
+    return Operation::MakeList<true>(cleaner_, arguments_, 0);
 }
 
-ListRef::ListRef(Object* arg_obj, Scope* scope) : Operation(arg_obj, scope) {}
-Object* ListRef::PerformOnArgs() {
-    if (arguments_.size() != 2 || !Is<Cell>(arguments_.front()) || 
-            !Is<Number>(arguments_.back())) {
+Object* ListRef(BaseOpHolder::Arguments arguments, Cleaner*) {
+    if (arguments.size() != 2 || !Is<Cell>(arguments.front()) || 
+            !Is<Number>(arguments.back())) {
         throw RuntimeError("Invalid arguments for ListRef operation");
     }
 
-    Object* list_iter = arguments_.front();
-    size_t queried_index = static_cast<size_t>(As<Number>(arguments_.back())->GetValue());
-    Object* queried_element = nullptr;
-
-    size_t current_ind = 0;
-    while (Is<Cell>(list_iter)) {
-        if (current_ind == queried_index) {
-            queried_element = As<Cell>(list_iter)->GetFirst();
-        }
+    Object* list_iter = arguments.front();
+    size_t queried_index = static_cast<size_t>(GetNumber(arguments.back()));
+    for (size_t i = 0; i < queried_index && Is<Cell>(list_iter); ++i) {
         list_iter = As<Cell>(list_iter)->GetSecond();
-        ++current_ind;
-    }
-    if (list_iter != nullptr) {
-        throw RuntimeError("Argument is not a correct list in ListRef operation");
     }
-    if (current_ind <= queried_index) {
+    if (!Is<Cell>(list_iter)) {
         throw RuntimeError("Index out of bounds");
     }
-    return queried_element;
-
+    return As<Cell>(list_iter)->GetFirst();
 }
 
-ListTail::ListTail(Object* arg_obj, Scope* scope) : Operation(arg_obj, scope) {}
-Object* ListTail::PerformOnArgs() {
-   if (arguments_.size() != 2 || !Is<Cell>(arguments_.front()) || 
-            !Is<Number>(arguments_.back())) {
+Object* ListTail(BaseOpHolder::Arguments arguments, Cleaner*) {
+   if (arguments.size() != 2 || !Is<Cell>(arguments.front()) || 
+            !Is<Number>(arguments.back())) {
         throw RuntimeError("Invalid arguments for ListTail operation");
     }
-    size_t queried_index = static_cast<size_t>(As<Number>(arguments_.back())->GetValue());
-    Arguments list_elements;
-    Object* list_iter = arguments_.front();
-    while (Is<Cell>(list_iter)) {
-        list_elements.push_back(As<Cell>(list_iter)->GetFirst());
+    size_t queried_index = static_cast<size_t>(GetNumber(arguments.back()));
+    Object* list_iter = arguments.front();
+    for (size_t i = 0; i < queried_index; ++i) {
+        if (!Is<Cell>(list_iter)) {
+            throw RuntimeError("Index out of bounds");
+        }
         list_iter = As<Cell>(list_iter)->GetSecond();
     }
-    if (list_iter != nullptr) {
-        throw RuntimeError("Argument is not a correct list in ListTail operation");
-    }
-    if (list_elements.size() < queried_index) {
-        throw RuntimeError("Index out of bounds");
-    }
-    return MakeList<true>(list_elements, queried_index);
+    return list_iter;
 }
 
-Quote::Quote(Object* arg_obj) {
-    if (!Is<Cell>(arg_obj)) {
-        throw RuntimeError("Invalid arguments for Quote");
+Object* IsSymbol(BaseOpHolder::Arguments arguments, Cleaner*) {
+    if (arguments.empty() || arguments.size() > 1) {
+        throw RuntimeError("Invalid args for symbol?");
     }
-    if (Is<Cell>(As<Cell>(arg_obj)->GetSecond())) {
-        auto second_arg = As<Cell>(As<Cell>(arg_obj)->GetSecond());
-        if (second_arg->GetFirst() == nullptr && second_arg->GetSecond() == nullptr) {
-            throw RuntimeError("Invalid arguments for Quote");
-        }
+    bool res_state = true;
+    auto arg = arguments.front();
+    if (!Is<Symbol>(arg)) {
+        res_state = false;
     }
-    quoted_object_ = As<Cell>(arg_obj)->GetFirst();
-}
-Object* Quote::PerformOnArgs() {
-    return quoted_object_;
-}
 
-IfStatement::IfStatement(Object* arg_obj, Scope* scope) : condition_(nullptr), true_branch_(nullptr), false_branch_(nullptr) {
-    scope_ = scope;
-
-    if (!Is<Cell>(arg_obj)) {
-        ThrowSyntax();
-    }
-    auto cond = As<Cell>(arg_obj)->GetFirst();
-    condition_ = cond->Exec(scope);
+    return ConstructBool(res_state);
+}
 
-    arg_obj = As<Cell>(arg_obj)->GetSecond();
-    if (!Is<Cell>(arg_obj)) {
-        ThrowSyntax();
+Object* SetCar(BaseOpHolder::Arguments arguments, Cleaner* cleaner) {
+    if (arguments.size() != 2 || !Is<Cell>(arguments.front())) {
+        throw RuntimeError("Wrong args for set-car");
     }
-    true_branch_ = As<Cell>(arg_obj)->GetFirst();
+    As<Cell>(arguments.front())->SetFirst(arguments.back(), cleaner);
+    return nullptr;
+}
 
-    arg_obj = As<Cell>(arg_obj)->GetSecond();
-    if (arg_obj != nullptr) {
-        if (!Is<Cell>(arg_obj)) {
-            ThrowSyntax();
-        }
-        false_branch_ = As<Cell>(arg_obj)->GetFirst();
-        arg_obj = As<Cell>(arg_obj)->GetSecond();
-        if (arg_obj != nullptr) {
-            ThrowSyntax();
-        }
+Object* SetCdr(BaseOpHolder::Arguments arguments, Cleaner* cleaner) {
+    if (arguments.size() != 2 || !Is<Cell>(arguments.front())) {
+        throw RuntimeError("Wrong arg for set-cdr");
     }
+    As<Cell>(arguments.front())->SetSecond(arguments.back(), cleaner);
+    return nullptr;
 }
 
+namespace {
 
-
-Object* IfStatement::PerformOnArgs() {
-    bool state = true;
-
-    if (Is<Symbol>(condition_)) {
-        if (As<Symbol>(condition_)->GetName() != "#f") {
-            state = true;
-        } else {
-            state = false;
-        }
-    } else {
-        state = true;
-    }
-    if (state) {
-        return true_branch_->Exec(scope_);
-    } else {
-        if (false_branch_ != nullptr) {
-            return false_branch_->Exec(scope_);
-        } else {
-            return false_branch_;
-        }
+// Checks the index argument of a vector operation against the vector size.
+size_t VectorIndex(Object* index, size_t size) {
+    if (!Is<Number>(index)) {
+        throw RuntimeError("Invalid index for vector operation");
     }
-}
-
-LambdaFunction::LambdaFunction(
-    LambdaScheme* scheme,
-    Object* arg_obj,
-    Scope* scope) : scheme_(scheme) {
-    if (scheme_->IsCC()) {
-        scope_ = Cleaner::kCleaner->MakeScope(scheme_->GetCCScope());
-    } else {
-        scope_ = Cleaner::kCleaner->MakeScope(scope);
+    int value = GetNumber(index);
+    if (value < 0 || static_cast<size_t>(value) >= size) {
+        throw RuntimeError("Index out of bounds");
     }
+    return static_cast<size_t>(value);
+}
 
-    std::vector<Object*> input_args;
-    while (arg_obj != nullptr) {
-        auto elem = As<Cell>(arg_obj)->GetFirst();
-        if (Is<Symbol>(elem)) {
-            elem = FindElemInScope(As<Symbol>(elem)->GetName(), scope_);
-        }
-        input_args.push_back(elem->Exec(scope_));
-        arg_obj = As<Cell>(arg_obj)->GetSecond();
-    }
+}  // namespace
 
-    const std::vector<std::string>& names = scheme->ReturnArgs();
-    if (names.size() != input_args.size()) {
-        throw RuntimeError("Incorrect num of args");
+Object* IsVector(BaseOpHolder::Arguments arguments, Cleaner*) {
+    if (arguments.size() != 1) {
+        throw RuntimeError("Invalid args for vector?");
     }
-    for (size_t i = 0; i < input_args.size(); ++i) {
-        scope_->AddName(names[i], input_args[i]);
-    }    
+    return ConstructBool(Is<Vector>(arguments.front()));
 }
 
-Object* LambdaFunction::PerformOnArgs() {
-    Object* value;
-    for (const auto& function : scheme_->ReturnFuncs()) {
-        value = function->Exec(scope_);
-        if (Is<Symbol>(value)) {
-            value = FindElemInScope(As<Symbol>(value)->GetName(), scope_);
-        }
+MakeVector::MakeVector(Arguments arguments, Cleaner* cleaner) : Operation(std::move(arguments), cleaner) {}
+Object* MakeVector::PerformOnArgs() {
+    if (arguments_.empty() || arguments_.size() > 2 || !Is<Number>(arguments_.front()) ||
+            GetNumber(arguments_.front()) < 0) {
+        throw RuntimeError("Invalid arguments for MakeVector operation");
     }
-    return value;
+    Object* fill = (arguments_.size() == 2) ? arguments_.back() : nullptr;
+    return cleaner_->Make<Vector>(static_cast<size_t>(GetNumber(arguments_.front())), fill);
 }
 
-Define::Define(Object* arg_obj, Scope* scope) {
-    scope_ = scope;
+ConstructVector::ConstructVector(Arguments arguments, Cleaner* cleaner) : Operation(std::move(arguments), cleaner) {}
+Object* ConstructVector::PerformOnArgs() {
+    return cleaner_->Make<Vector>(std::vector<Object*>(arguments_.begin(), arguments_.end()));
+}
 
-    if (!Is<Cell>(arg_obj)) {
-        ThrowSyntax();
+Object* VectorLength(BaseOpHolder::Arguments arguments, Cleaner*) {
+    if (arguments.size() != 1 || !Is<Vector>(arguments.front())) {
+        throw RuntimeError("Invalid arguments for VectorLength operation");
     }
-    auto header = As<Cell>(arg_obj)->GetFirst();
-    if (Is<Cell>(header)) {
-        Object* lambda_scheme = Cleaner::kCleaner->Make<LambdaScheme>(arg_obj, scope, true, false);
-        new_elem_ = lambda_scheme;
-        name_ = As<LambdaScheme>(lambda_scheme)->GetName();
-    } else {
-        if (!Is<Symbol>(header)) {
-            ThrowSyntax();
-        }
-        name_ = As<Symbol>(header)->GetName();
-        arg_obj = As<Cell>(arg_obj)->GetSecond();
-        if (!Is<Cell>(arg_obj)) {
-            ThrowSyntax();
-        }
-        auto elem = As<Cell>(arg_obj)->GetFirst();
-        if(Is<Symbol>(elem)) {
-            auto elem_from_scope = FindElemInScope(As<Symbol>(elem)->GetName(), scope);
-            if (Is<OpHolder<Quote>>(elem_from_scope)) {
-                pure_obj_stored_ = true;
-                arg_obj = As<Cell>(arg_obj)->GetSecond();
-                new_elem_ = As<Cell>(arg_obj)->GetFirst();
-                return;
-            }
-        }
-
-        if (As<Cell>(arg_obj)->GetSecond() != nullptr) {
-            ThrowSyntax();
-        }
+    return MakeNumber(static_cast<int>(As<Vector>(arguments.front())->Size()));
+}
 
-        arg_obj = As<Cell>(arg_obj)->GetFirst();
-        if(!Is<Cell>(arg_obj)) {
-            if (Is<Symbol>(As<Cell>(arg_obj)->GetFirst())) {
-                auto symb = As<Symbol>(As<Cell>(arg_obj)->GetFirst());
-                auto elem_from_scope = FindElemInScope(symb->GetName(), scope);
-                if (Is<OpHolder<LambdaScheme>>(elem_from_scope)) {
-                    new_elem_ = Cleaner::kCleaner->Make<LambdaScheme>(As<Cell>(arg_obj)->GetSecond(), scope, false, false);
-                    As<LambdaScheme>(new_elem_)->GetName() = name_;
-                    return;
-                }
-            }
-        }
-        new_elem_ = arg_obj->Exec(scope);
+Object* VectorRef(BaseOpHolder::Arguments arguments, Cleaner*) {
+    if (arguments.size() != 2 || !Is<Vector>(arguments.front())) {
+        throw RuntimeError("Invalid arguments for VectorRef operation");
     }
+    Vector* vector = As<Vector>(arguments.front());
+    return vector->Get(VectorIndex(arguments.back(), vector->Size()));
 }
 
-Object* Define::PerformOnArgs() {
-    if (pure_obj_stored_) {
-        if (Is<Cell>(new_elem_)) {
-            As<Cell>(new_elem_)->SetName(name_);
-        }
+Object* VectorSet(BaseOpHolder::Arguments arguments, Cleaner* cleaner) {
+    if (arguments.size() != 3 || !Is<Vector>(arguments.front())) {
+        throw RuntimeError("Invalid arguments for VectorSet operation");
     }
-    scope_->AddName(name_, new_elem_);
+    Vector* vector = As<Vector>(arguments.front());
+    vector->Set(VectorIndex(arguments[1], vector->Size()), arguments[2], cleaner);
     return nullptr;
 }
 
-Set::Set(Object* arg_obj, Scope* scope) {
-    scope_ = scope;
-
-    if (!Is<Cell>(arg_obj)) {
-            ThrowSyntax();
-        }
-        auto elem = As<Cell>(arg_obj)->GetFirst();
-        if (!Is<Symbol>(elem)) {
-            ThrowSyntax();
-        }
-        name_ = As<Symbol>(elem)->GetName();
-        arg_obj = As<Cell>(arg_obj)->GetSecond();
-        if (!As<Cell>(arg_obj)) {
-            ThrowSyntax();
-        }
-        if (As<Cell>(arg_obj)->GetSecond() != nullptr) {
-            ThrowSyntax();
-        }
-        new_elem_ = As<Cell>(arg_obj)->GetFirst()->Exec(scope);
-}
-
-Object* Set::PerformOnArgs() {
-    scope_ = FindScope(name_, scope_);
-    scope_->AddName(name_, new_elem_);
+Object* VectorFill(BaseOpHolder::Arguments arguments, Cleaner* cleaner) {
+    if (arguments.size() != 2 || !Is<Vector>(arguments.front())) {
+        throw RuntimeError("Invalid arguments for VectorFill operation");
+    }
+    As<Vector>(arguments.front())->Fill(arguments.back(), cleaner);
     return nullptr;
 }
 
-IsSymbol::IsSymbol(Object* arg_obj, Scope* scope) : Operation(arg_obj, scope) {}
-Object* IsSymbol::PerformOnArgs() {
-    if (arguments_.empty() || arguments_.size() > 1) {
-        throw RuntimeError("Invalid args for symbol?");
+Object* VectorToList(BaseOpHolder::Arguments arguments, Cleaner* cleaner) {
+    if (arguments.size() != 1 || !Is<Vector>(arguments.front())) {
+        throw RuntimeError("Invalid arguments for VectorToList operation");
     }
-    bool res_state = true;
-    auto arg = arguments_.front();
-    if (!Is<Symbol>(arg)) {
-        res_state = false;
+    Vector* vector = As<Vector>(arguments.front());
+    Object* list = nullptr;
+    for (size_t i = vector->Size(); i > 0; --i) {
+        list = cleaner->Make<Cell>(vector->Get(i - 1), list);
     }
-
-    return ConstructBool(res_state);
+    return list;
 }
 
-bool QCheckIsPair(Object* obj) {
-    uint counter = 0;
-    while (Is<Cell>(obj)) {
-        ++counter;
-        if (counter >= 2) {
-            return false;
-        }
-        obj = As<Cell>(obj)->GetSecond();
-        if (Is<Cell>(obj)) {
-            if (As<Cell>(obj)->GetName() != nullptr) {
-                return true;
-            }
-        }
+Object* ListToVector(BaseOpHolder::Arguments arguments, Cleaner* cleaner) {
+    if (arguments.size() != 1) {
+        throw RuntimeError("Invalid arguments for ListToVector operation");
+    }
+    std::vector<Object*> elements;
+    Object* list_iter = arguments.front();
+    while (Is<Cell>(list_iter)) {
+        elements.push_back(As<Cell>(list_iter)->GetFirst());
+        list_iter = As<Cell>(list_iter)->GetSecond();
+    }
+    if (list_iter != nullptr) {
+        throw RuntimeError("Argument is not a correct list in ListToVector operation");
     }
-    return false;
+    return cleaner->Make<Vector>(std::move(elements));
 }
 
-SetCar::SetCar(Object* arg_obj, Scope* scope) {
-    scope_ = scope;
+Object* IsHashTable(BaseOpHolder::Arguments arguments, Cleaner*) {
+    if (arguments.size() != 1) {
+        throw RuntimeError("Invalid args for hash-table?");
+    }
+    return ConstructBool(Is<HashTable>(arguments.front()));
+}
 
-     if (!Is<Cell>(arg_obj)) {
-        ThrowSyntax();
+Object* MakeHashTable(BaseOpHolder::Arguments arguments, Cleaner* cleaner) {
+    if (!arguments.empty()) {
+        throw RuntimeError("Invalid arguments for MakeHashTable operation");
     }
-    Object* elem = As<Cell>(arg_obj)->GetFirst();
-    if (Is<Cell>(elem)) {
-        elem = elem->Exec(scope);
-        if (Is<Cell>(elem)) {
-            elem = As<Cell>(elem)->GetName();
-        }
+    return cleaner->Make<HashTable>();
+}
+
+HashTableRef::HashTableRef(Arguments arguments, Cleaner* cleaner) : Operation(std::move(arguments), cleaner) {}
+Object* HashTableRef::PerformOnArgs() {
+    if (arguments_.size() < 2 || arguments_.size() > 3 || !Is<HashTable>(arguments_.front())) {
+        throw RuntimeError("Invalid arguments for HashTableRef operation");
     }
-    name_ = As<Symbol>(elem)->GetName();
-    arg_obj = As<Cell>(arg_obj)->GetSecond();
-    if (!As<Cell>(arg_obj)) {
-        ThrowSyntax();
+    Object** value = As<HashTable>(arguments_.front())->Find(arguments_[1]);
+    if (value != nullptr) {
+        return *value;
     }
-    if (As<Cell>(arg_obj)->GetSecond() != nullptr) {
-        ThrowSyntax();
+    if (arguments_.size() == 3) {
+        return arguments_[2];
     }
-    new_elem_ = As<Cell>(arg_obj)->GetFirst()->Exec(scope);
+    throw RuntimeError("No such key in hash table");
 }
 
-Object* SetCar::PerformOnArgs() {
-    auto pair = FindElemInScope(name_, scope_);
-    if (!QCheckIsPair(pair)) {
-        throw RuntimeError("Wrong args for set-car");
+Object* HashTableSet(BaseOpHolder::Arguments arguments, Cleaner* cleaner) {
+    if (arguments.size() != 3 || !Is<HashTable>(arguments.front())) {
+        throw RuntimeError("Invalid arguments for HashTableSet operation");
     }
-    As<Cell>(pair)->SetFirst((new_elem_));
+    As<HashTable>(arguments.front())->Set(arguments[1], arguments[2], cleaner);
     return nullptr;
 }
 
-SetCdr::SetCdr(Object* arg_obj, Scope* scope) {
-    scope_ = scope;
-
-    if (!Is<Cell>(arg_obj)) {
-            ThrowSyntax();
-    }
-    auto elem = As<Cell>(arg_obj)->GetFirst();
-    if (Is<Cell>(elem)) {
-        elem = elem->Exec(scope);
-        if (Is<Cell>(elem)) {
-            elem = As<Cell>(elem)->GetName();
-        }
+Object* HashTableDelete(BaseOpHolder::Arguments arguments, Cleaner*) {
+    if (arguments.size() != 2 || !Is<HashTable>(arguments.front())) {
+        throw RuntimeError("Invalid arguments for HashTableDelete operation");
     }
-    name_ = As<Symbol>(elem)->GetName();
-    arg_obj = As<Cell>(arg_obj)->GetSecond();
-    if (!As<Cell>(arg_obj)) {
-        ThrowSyntax();
-    }
-    if (As<Cell>(arg_obj)->GetSecond() != nullptr) {
-        ThrowSyntax();
+    As<HashTable>(arguments.front())->Erase(arguments.back());
+    return nullptr;
+}
+
+Object* HashTableCount(BaseOpHolder::Arguments arguments, Cleaner*) {
+    if (arguments.size() != 1 || !Is<HashTable>(arguments.front())) {
+        throw RuntimeError("Invalid arguments for HashTableCount operation");
     }
-    new_elem_ = As<Cell>(arg_obj)->GetFirst()->Exec(scope);
+    return MakeNumber(static_cast<int>(As<HashTable>(arguments.front())->Count()));
 }
 
-Object* SetCdr::PerformOnArgs() {
-    auto pair = FindElemInScope(name_, scope_);
-    if (!QCheckIsPair(pair)) {
-        throw RuntimeError("Wrong arg for set-cdr");
+Object* HashTableToAlist(BaseOpHolder::Arguments arguments, Cleaner* cleaner) {
+    if (arguments.size() != 1 || !Is<HashTable>(arguments.front())) {
+        throw RuntimeError("Invalid arguments for HashTableToAlist operation");
     }
-    As<Cell>(pair)->SetSecond(new_elem_);
-    return nullptr;
-}
\ No newline at end of file
+    Object* alist = nullptr;
+    As<HashTable>(arguments.front())->ForEach([cleaner, &alist](Object* key, Object* value) {
+        alist = cleaner->Make<Cell>(cleaner->Make<Cell>(key, value), alist);
+    });
+    return alist;
+}
@@ -1,116 +1,104 @@
 #include "parser.h"
+#include <limits>
 #include <vector>
 #include "error.h"
 
-static Object* PackProperList(std::vector<Object*>& vector, size_t ind = 0) {
-    Object* res = nullptr;
-    if (ind == vector.size() - 1) {
-        res = Cleaner::kCleaner->Make<Cell>(vector[ind], nullptr);
-        return res;
-    }
-    res = Cleaner::kCleaner->Make<Cell>(vector[ind], PackProperList(vector, ind + 1));
-    return res;
-}
+namespace {
 
-static Object* PackUnproperList(std::vector<Object*>& vector, size_t ind = 0) {
-    Object* res;
-    if (ind == vector.size() - 1) {
-        res = vector[ind];
-        return res;
-    }
-    res = Cleaner::kCleaner->Make<Cell>(vector[ind], PackUnproperList(vector, ind + 1));
-    return res;
-}
+constexpr size_t kNoDot = std::numeric_limits<size_t>::max();
 
-Object* ReadList(Tokenizer* tokenizer);
+// A list whose closing bracket has not been read yet. Its elements are the
+// items from begin to the top of the item stack.
+struct OpenList {
+    size_t begin;
+    // Number of elements before the dot.
+    size_t dot_pos;
+};
 
-Object* Read(Tokenizer* tokenizer) {
-    if (tokenizer->IsEnd()) {
-        throw SyntaxError("1");
+// Reads a token that is neither a bracket nor a dot.
+Object* ReadAtom(const Token& token, Cleaner* cleaner) {
+    if (const ConstantToken* const_token = std::get_if<ConstantToken>(&token)) {
+        return MakeNumber(const_token->value);
     }
-
-    Object* obj_ptr = nullptr;
-    Token curr_token = tokenizer->GetToken();
-
-    if (BracketToken* brace_token = std::get_if<BracketToken>(&curr_token)) {
-        if (*brace_token == BracketToken::OPEN) {
-            obj_ptr = ReadList(tokenizer);
+    if (const SymbolToken* symb_token = std::get_if<SymbolToken>(&token)) {
+        if (symb_token->name == "#t" || symb_token->name == "#f") {
+            return ConstructBool(symb_token->name == "#t");
         }
+        return cleaner->Intern(symb_token->name);
+    }
+    if (std::holds_alternative<QuoteToken>(token)) {
+        return cleaner->Intern("quote");
+    }
+    return nullptr;
+}
 
-    } else {
-        if (ConstantToken* const_token = std::get_if<ConstantToken>(&curr_token)) {
-            obj_ptr = Cleaner::kCleaner->Make<Number>(const_token->value);
-        } else if (SymbolToken* symb_token = std::get_if<SymbolToken>(&curr_token)) {
-            obj_ptr = Cleaner::kCleaner->Make<Symbol>(symb_token->name);
-        } else if (QuoteToken* quote_token = std::get_if<QuoteToken>(&curr_token)) {
-            obj_ptr = Cleaner::kCleaner->Make<Symbol>("quote");
+// Pops the elements of the list off the item stack and conses them up from
+// the tail.
+Object* CloseList(const OpenList& list, std::vector<Object*>* items, Cleaner* cleaner) {
+    Object* tail = nullptr;
+    if (list.dot_pos != kNoDot) {
+        size_t size = items->size() - list.begin;
+        if (size < 2 || list.dot_pos != size - 1) {
+            throw SyntaxError("1");
         }
+        tail = items->back();
+        items->pop_back();
     }
-    tokenizer->Next();
-    if (tokenizer->IsEnd()) {
-        if (Is<Symbol>(obj_ptr)) {
-            if (As<Symbol>(obj_ptr)->GetName() == "quote") {
-                throw SyntaxError("1");
-            }
-        }
+    while (items->size() > list.begin) {
+        tail = cleaner->Make<Cell>(items->back(), tail);
+        items->pop_back();
     }
-    return obj_ptr;
+    return tail;
 }
 
-Object* ReadList(Tokenizer* tokenizer) {
-    tokenizer->Next();
-    std::vector<Object*> objs;
+}  // namespace
 
-    int dot_pos = -1;
-    int counter = 0;
+Object* Read(Tokenizer* tokenizer, Cleaner* cleaner) {
+    std::vector<OpenList> lists;
+    std::vector<Object*> items;
     while (true) {
         if (tokenizer->IsEnd()) {
             throw SyntaxError("1");
         }
-        Token curr_token = tokenizer->GetToken();
-        if (BracketToken* brace_token = std::get_if<BracketToken>(&curr_token)) {
-            if ((*brace_token) == BracketToken::CLOSE) {
-                break;
-            }
+        const Token& token = tokenizer->GetToken();
+        const BracketToken* bracket = std::get_if<BracketToken>(&token);
+        if (bracket && *bracket == BracketToken::OPEN) {
+            lists.push_back({items.size(), kNoDot});
+            tokenizer->Next();
+            continue;
         }
-        if (DotToken* dot_token = std::get_if<DotToken>(&curr_token)) {
-            if (dot_pos != -1) {
+
+        Object* obj = nullptr;
+        if (lists.empty()) {
+            // A stray closing bracket or dot reads as nothing.
+            if (!bracket) {
+                obj = ReadAtom(token, cleaner);
+            }
+        } else if (bracket) {
+            obj = CloseList(lists.back(), &items, cleaner);
+            lists.pop_back();
+        } else if (std::holds_alternative<DotToken>(token)) {
+            OpenList& list = lists.back();
+            if (list.dot_pos != kNoDot) {
                 throw SyntaxError("1");
             }
-            dot_pos = counter;
+            list.dot_pos = items.size() - list.begin;
             tokenizer->Next();
             continue;
+        } else {
+            obj = ReadAtom(token, cleaner);
         }
 
-        objs.push_back(Read(tokenizer));
-
-        ++counter;
-    }
-    Object* ret_object = nullptr;
-
-    if (objs.empty()) {
-        if (dot_pos != -1) {
+        tokenizer->Next();
+        // Only a quote needs the token after it. A whole top-level form
+        // returns without scanning further.
+        if (Is<Symbol>(obj) && As<Symbol>(obj)->GetId() == Symbol::kQuoteId &&
+            tokenizer->IsEnd()) {
             throw SyntaxError("1");
         }
-        return ret_object;
-    }
-    if (objs.size() == 2) {
-        if (dot_pos == -1) {
-            ret_object = PackProperList(objs);
-        } else {
-            if (dot_pos != 1) {
-                throw SyntaxError("1");
-            }
-            ret_object = Cleaner::kCleaner->Make<Cell>(objs.front(), objs.back());
+        if (lists.empty()) {
+            return obj;
         }
-    } else if (dot_pos != -1) {
-        if (static_cast<size_t>(dot_pos) != objs.size() - 1 || objs.size() == 1) {
-            throw SyntaxError("1");
-        }
-        ret_object = PackUnproperList(objs);
-    } else {
-        ret_object = PackProperList(objs);
+        items.push_back(obj);
     }
-
-    return ret_object;
-}
\ No newline at end of file
+}
@@ -1,37 +1,91 @@
 #include "scheme.h"
+#include "analyzer.h"
+#include "compiler.h"
 #include "error.h"
 #include "parser.h"
-#include <sstream>
+
+namespace {
+
+// Builtins that call procedures, defined in Scheme on top of the native
+// ones since builtins do not run Scheme code.
+const char* const kPrelude[] = {
+    "(define (hash-table-walk table proc)"
+    "  (define (walk entries)"
+    "    (if (null? entries)"
+    "        '()"
+    "        ((lambda (ignored) (walk (cdr entries)))"
+    "         (proc (car (car entries)) (cdr (car entries))))))"
+    "  (walk (hash-table->alist table)))",
+};
+
+}  // namespace
+
+Interpreter::Interpreter(size_t max_depth)
+    : global_scope_(cleaner_.MakeScope()), machine_(&cleaner_, global_scope_, max_depth) {
+    cleaner_.AddRoot(global_scope_);
+    for (const char* definition : kPrelude) {
+        Run(definition);
+    }
+}
 
 std::string Interpreter::Run(const std::string& str) {
-    std::stringstream input_stream(PreprocessInputStr(str));
-    Tokenizer tokenizer(&input_stream);
-    Object* parsed_obj = Read(&tokenizer);
+    std::string wrapped;
+    Tokenizer tokenizer(PreprocessInputStr(str, &wrapped));
+    Object* parsed_obj = Read(&tokenizer, &cleaner_);
     if (!tokenizer.IsEnd()) {
         throw SyntaxError("Syntax error occured, input string processing didn't reach and end");
     }
+    return Eval(parsed_obj);
+}
+
+bool Interpreter::RunNext(Tokenizer* tokenizer, std::string* result) {
+    Object* parsed_obj;
+    try {
+        if (tokenizer->IsEnd()) {
+            return false;
+        }
+        // A quote at top level applies to the datum after it, as Run arranges
+        // by wrapping the input.
+        if (std::holds_alternative<QuoteToken>(tokenizer->GetToken())) {
+            tokenizer->Next();
+            Object* datum = Read(tokenizer, &cleaner_);
+            parsed_obj =
+                cleaner_.Make<Cell>(cleaner_.Intern("quote"), cleaner_.Make<Cell>(datum, nullptr));
+        } else {
+            parsed_obj = Read(tokenizer, &cleaner_);
+        }
+    } catch (const SyntaxError& error) {
+        throw ReadError(error.what());
+    }
+    *result = Eval(parsed_obj);
+    return true;
+}
+
+std::string Interpreter::Eval(Object* parsed_obj) {
     if (!parsed_obj) {
         throw RuntimeError("Given object is empty, nothing to execute");
     }
 
-    auto main_scope = new Scope();
+    Code* code = CompileTopLevel(Analyze(parsed_obj, &cleaner_), &cleaner_);
+    std::string res_str = FormatObject(machine_.Run(code));
 
-    Object* result_after_execution = parsed_obj->Exec(main_scope);
-    auto res_str = result_after_execution == nullptr ? "()" : result_after_execution->Format();
-
-    Cleaner::kCleaner->Sweep(main_scope);
-    ++Cleaner::counter;
+    cleaner_.SafePoint();
 
     return res_str;
 }
 
-std::string Interpreter::PreprocessInputStr(std::string str) {
-    if (str[0] == '\'') {
-        str = "(" + str + ")";
+std::string_view Interpreter::PreprocessInputStr(std::string_view str, std::string* storage) {
+    if (!str.empty() && str.front() == '\'') {
+        *storage = "(" + std::string(str) + ")";
+        return *storage;
     }
     return str;
 }
 
 Interpreter::~Interpreter() {
-    Cleaner::kCleaner->DeleteAll();
+    cleaner_.DeleteAll();
+}
+
+Cleaner* Interpreter::GetCleaner() {
+    return &cleaner_;
 }
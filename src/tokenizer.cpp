@@ -1,141 +1,188 @@
 #include "tokenizer.h"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <iterator>
+#include <ostream>
 #include "error.h"
 
-bool Tokenizer::IsDot(const char& ch) {
-    return ch == '.';
-}
-bool Tokenizer::IsQuote(const char& ch) {
-    return ch == 39;
-}
-bool Tokenizer::IsPlusMinus(const char& ch) {
-    return (ch == '+') || (ch == '-');
-}
-bool Tokenizer::IsDigit(const char& ch) {
-    return (ch >= 48 && ch <= 57);
-}
-bool Tokenizer::IsOpenBracket(const char& ch) {
-    return ch == 40;
-}
-bool Tokenizer::IsCloseBracket(const char& ch) {
-    return ch == 41;
-}
-
-bool Tokenizer::IsOpeningSymbol(const char& ch) {
-    return (ch >= 65 && ch <= 90) || (ch >= 97 && ch <= 122) || (ch == '*') || (ch == '/') ||
-           (ch == '#') || (ch == '=') || (ch == '>') || (ch == '<');
-}
-
-bool Tokenizer::IsInnerSymbol(const char& ch) {
-    return IsOpeningSymbol(ch) || IsDigit(ch) || ch == '?' || ch == '!' || ch == '-';
-}
-
-int Tokenizer::ReadNum(char& ch) {
-    std::string str_num = {ch};
-    while (IsDigit(in_->peek())) {
-        str_num += in_->get();
+namespace {
+
+enum CharClass : uint8_t {
+    kSpace = 1 << 0,
+    kDigit = 1 << 1,
+    // Starts a symbol.
+    kOpening = 1 << 2,
+    // Continues a symbol.
+    kInner = 1 << 3,
+    // Ends any token and is a token by itself.
+    kDelimiter = 1 << 4,
+};
+
+constexpr std::array<uint8_t, 256> MakeCharClasses() {
+    std::array<uint8_t, 256> classes{};
+    for (unsigned char ch : std::string_view(" \n\t\r")) {
+        classes[ch] = kSpace;
     }
-
-    return std::stoi(str_num);
+    for (int ch = '0'; ch <= '9'; ++ch) {
+        classes[ch] = kDigit | kInner;
+    }
+    for (int ch = 'a'; ch <= 'z'; ++ch) {
+        classes[ch] = kOpening | kInner;
+        classes[ch - 'a' + 'A'] = kOpening | kInner;
+    }
+    for (unsigned char ch : std::string_view("*/#=><")) {
+        classes[ch] = kOpening | kInner;
+    }
+    for (unsigned char ch : std::string_view("?!-")) {
+        classes[ch] = kInner;
+    }
+    for (unsigned char ch : std::string_view("()'.")) {
+        classes[ch] = kDelimiter;
+    }
+    return classes;
 }
 
-std::string Tokenizer::ReadSymbols(char& ch) {
-    std::string str = {ch};
-    while (IsInnerSymbol(in_->peek())) {
-        str += in_->get();
-    }
+constexpr std::array<uint8_t, 256> kCharClasses = MakeCharClasses();
 
-    return str;
+bool HasClass(char ch, uint8_t char_class) {
+    return kCharClasses[static_cast<unsigned char>(ch)] & char_class;
 }
 
-bool Tokenizer::IsValid(const char& ch) {
-    return (IsDot(ch) || IsQuote(ch) || IsDigit(ch) || IsPlusMinus(ch) || IsOpeningSymbol(ch) ||
-            IsOpenBracket(ch) || IsCloseBracket(ch));
+}  // namespace
+
+Tokenizer::Tokenizer(std::string_view source)
+    : source_(source), pos_(0), in_(nullptr), is_end_(false), pending_(false) {
+    Advance();
 }
 
-Tokenizer::Tokenizer(std::istream* in) {
-    in_ = in;
-    is_end_ = false;
-    Next();
+Tokenizer::Tokenizer(std::istream* in) : pos_(0), in_(in), is_end_(false), pending_(false) {
+    Advance();
 }
 
 bool Tokenizer::IsEnd() {
+    if (pending_) {
+        Advance();
+    }
     return is_end_;
 }
 
-void Tokenizer::Next() {
-    char curr_char = ' ';
-    while (in_->peek() != EOF) {
-        curr_char = in_->get();
-        if (IsValid(curr_char)) {
-            break;
-        } else {
-            if (curr_char != '\n' && curr_char != ' ') {
-                throw SyntaxError("Syntax Error");
-            }
-        }
+bool Tokenizer::Refill() {
+    // As a sentry of the stream would, lets the tied output show before
+    // waiting for input.
+    if (std::ostream* tied = in_->tie()) {
+        tied->flush();
     }
-    if (curr_char == ' ') {
-        is_end_ = true;
-        return;
+    std::streambuf* buf = in_->rdbuf();
+    // Peeking makes the stream buffer read from its source when empty.
+    if (buf->sgetc() == std::char_traits<char>::eof()) {
+        return false;
     }
+    auto size = std::clamp<std::streamsize>(buf->in_avail(), 1, kChunkSize);
+    buffer_.erase(0, pos_);
+    pos_ = 0;
+    size_t old_size = buffer_.size();
+    buffer_.resize(old_size + size);
+    buffer_.resize(old_size + buf->sgetn(buffer_.data() + old_size, size));
+    source_ = buffer_;
+    return true;
+}
 
-    if (IsQuote(curr_char)) {
-        curr_token_ = QuoteToken();
-        return;
-    }
-    if (IsDot(curr_char)) {
-        curr_token_ = DotToken();
-        return;
+bool Tokenizer::HasDelimiter() const {
+    for (size_t i = pos_; i < source_.size(); ++i) {
+        if (HasClass(source_[i], kSpace | kDelimiter)) {
+            return true;
+        }
     }
-    if (IsOpenBracket(curr_char)) {
-        curr_token_ = BracketToken::OPEN;
-        return;
+    return false;
+}
+
+void Tokenizer::SkipSpaces() {
+    while (pos_ < source_.size() && HasClass(source_[pos_], kSpace)) {
+        ++pos_;
     }
-    if (IsCloseBracket(curr_char)) {
-        curr_token_ = BracketToken::CLOSE;
-        return;
+}
+
+int Tokenizer::ReadNum(size_t begin) {
+    while (pos_ < source_.size() && HasClass(source_[pos_], kDigit)) {
+        ++pos_;
     }
-    if (IsDigit(curr_char)) {
-        curr_token_ = ConstantToken{.value = ReadNum(curr_char)};
-        return;
+    int value;
+    auto [end, error] = std::from_chars(source_.data() + begin, source_.data() + pos_, value);
+    if (error != std::errc()) {
+        throw SyntaxError("Number is out of range");
     }
+    return value;
+}
 
-    if (IsPlusMinus(curr_char)) {
-        const char sign_ch = curr_char;
-        if (IsDigit(in_->peek())) {
-            curr_char = in_->get();
-            int value = ReadNum(curr_char);
-            if (sign_ch == '-') {
-                value = -value;
-            }
-            curr_token_ = ConstantToken{.value = value};
-        } else {
-            std::string name{curr_char};
-            curr_token_ = SymbolToken{.name = name};
-        }
+void Tokenizer::Next() {
+    pending_ = true;
+}
 
+void Tokenizer::Advance() {
+    pending_ = false;
+    SkipSpaces();
+    // A token read from a stream is whole once a delimiter follows it or
+    // the stream has nothing more for now.
+    while (in_ != nullptr && !HasDelimiter() && Refill()) {
+        SkipSpaces();
+    }
+    if (pos_ == source_.size()) {
+        is_end_ = true;
         return;
     }
 
-    if (IsOpeningSymbol(curr_char)) {
-        if (curr_char == '#') {
-            if (in_->peek() == 't' || in_->peek() == 'f') {
-                char bool_ch = in_->get();
-                std::string name = "#";
-                name += bool_ch;
-                curr_token_ = SymbolToken{.name = name};
-                return;
+    size_t begin = pos_;
+    char curr_char = source_[pos_++];
+    char next_char = pos_ < source_.size() ? source_[pos_] : '\0';
+    switch (curr_char) {
+        case '\'':
+            curr_token_ = QuoteToken();
+            return;
+        case '.':
+            curr_token_ = DotToken();
+            return;
+        case '(':
+            curr_token_ = BracketToken::OPEN;
+            return;
+        case ')':
+            curr_token_ = BracketToken::CLOSE;
+            return;
+        case '+':
+        case '-':
+            if (HasClass(next_char, kDigit)) {
+                // from_chars takes a minus sign but not a plus.
+                curr_token_ = ConstantToken{.value = ReadNum(curr_char == '+' ? pos_ : begin)};
             } else {
+                curr_token_ = SymbolToken{.name = source_.substr(begin, 1)};
+            }
+            return;
+        case '#':
+            if (next_char != 't' && next_char != 'f') {
                 throw SyntaxError("1");
             }
-        }
-
-        std::string name = ReadSymbols(curr_char);
-        curr_token_ = SymbolToken{.name = name};
+            ++pos_;
+            curr_token_ = SymbolToken{.name = source_.substr(begin, 2)};
+            return;
     }
+    if (HasClass(curr_char, kDigit)) {
+        curr_token_ = ConstantToken{.value = ReadNum(begin)};
+        return;
+    }
+    if (!HasClass(curr_char, kOpening)) {
+        throw SyntaxError("Syntax Error");
+    }
+    while (pos_ < source_.size() && HasClass(source_[pos_], kInner)) {
+        ++pos_;
+    }
+    curr_token_ = SymbolToken{.name = source_.substr(begin, pos_ - begin)};
 }
 
-Token Tokenizer::GetToken() {
+const Token& Tokenizer::GetToken() {
+    if (pending_) {
+        Advance();
+    }
     return curr_token_;
 }
 
@@ -155,4 +202,4 @@ bool ConstantToken::operator==(const ConstantToken& other) const {
 
 bool BooleanToken::operator==(const BooleanToken& other) const {
     return state == other.state;
-}
\ No newline at end of file
+}
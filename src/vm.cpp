@@ -0,0 +1,318 @@
+#include "vm.h"
+#include "error.h"
+#include "node.h"
+#include "ops.h"
+
+namespace {
+
+Environment* FrameAt(Environment* env, uint32_t depth) {
+    for (uint32_t i = 0; i < depth; ++i) {
+        env = env->GetParent();
+    }
+    return env;
+}
+
+size_t BuiltinArity(Opcode op) {
+    switch (op) {
+        case Opcode::CAR:
+        case Opcode::CDR:
+        case Opcode::IS_NULL:
+        case Opcode::NOT:
+            return 1;
+        default:
+            return 2;
+    }
+}
+
+}  // namespace
+
+Machine::Machine(Cleaner* cleaner, Scope* global_scope, size_t max_depth)
+    : cleaner_(cleaner), global_scope_(global_scope), max_depth_(max_depth) {
+    cleaner_->AddRootSet(this);
+}
+
+Machine::~Machine() {
+    cleaner_->RemoveRootSet(this);
+}
+
+Object* Machine::Run(Code* code) {
+    size_t stack_base = stack_.size();
+    size_t frames_base = frames_.size();
+    frames_.push_back({code, code->Instructions(), nullptr, stack_base});
+    try {
+        return Loop(frames_base);
+    } catch (...) {
+        stack_.resize(stack_base);
+        frames_.resize(frames_base);
+        LowerUntouchedFrames();
+        throw;
+    }
+}
+
+Object* Machine::Loop(size_t frames_base) {
+    Frame* frame = &frames_.back();
+    const uint32_t* pc = frame->pc;
+    while (true) {
+        uint32_t word = *pc++;
+        uint32_t operand = DecodeOperand(word);
+        Opcode op = DecodeOpcode(word);
+        switch (op) {
+            case Opcode::CONST:
+                stack_.push_back(frame->code->GetObject(operand));
+                break;
+            case Opcode::LOCAL0:
+                stack_.push_back(frame->env->GetSlot(operand));
+                break;
+            case Opcode::LOCAL:
+                stack_.push_back(FrameAt(frame->env, *pc++)->GetSlot(operand));
+                break;
+            case Opcode::SET_LOCAL0:
+                frame->env->SetSlot(operand, stack_.back(), cleaner_);
+                stack_.back() = nullptr;
+                break;
+            case Opcode::SET_LOCAL:
+                FrameAt(frame->env, *pc++)->SetSlot(operand, stack_.back(), cleaner_);
+                stack_.back() = nullptr;
+                break;
+            case Opcode::GLOBAL:
+                stack_.push_back(LookupGlobal(frame->code, operand));
+                break;
+            case Opcode::SET_GLOBAL:
+            case Opcode::DEFINE_GLOBAL: {
+                Symbol* name = As<Symbol>(frame->code->GetObject(operand));
+                if (op == Opcode::SET_GLOBAL && !global_scope_->IsInScope(name)) {
+                    throw NameError("No such name found in scopes");
+                }
+                global_scope_->AddName(name, stack_.back());
+                stack_.back() = nullptr;
+                break;
+            }
+            case Opcode::CLOSURE:
+                stack_.push_back(
+                    cleaner_->Make<LambdaScheme>(frame->code->GetLambda(operand), frame->env));
+                break;
+            case Opcode::POP:
+                stack_.pop_back();
+                break;
+            case Opcode::JUMP:
+                pc = frame->code->Instructions() + operand;
+                break;
+            case Opcode::JUMP_IF_FALSE: {
+                Object* value = stack_.back();
+                stack_.pop_back();
+                if (IsFalse(value)) {
+                    pc = frame->code->Instructions() + operand;
+                }
+                break;
+            }
+            case Opcode::JUMP_IF_FALSE_OR_POP:
+            case Opcode::JUMP_IF_TRUE_OR_POP:
+                if (IsFalse(stack_.back()) == (op == Opcode::JUMP_IF_FALSE_OR_POP)) {
+                    pc = frame->code->Instructions() + operand;
+                } else {
+                    stack_.pop_back();
+                }
+                break;
+            case Opcode::CALL:
+                frame->pc = pc;
+                Call(operand, false);
+                frame = &frames_.back();
+                pc = frame->pc;
+                break;
+            case Opcode::TAIL_CALL:
+                if (Call(operand, true)) {
+                    frame = &frames_.back();
+                    pc = frame->pc;
+                    break;
+                }
+                [[fallthrough]];
+            case Opcode::RETURN: {
+                Object* result = stack_.back();
+                stack_.resize(frame->stack_base);
+                frames_.pop_back();
+                LowerUntouchedFrames();
+                if (frames_.size() == frames_base) {
+                    return result;
+                }
+                frame = &frames_.back();
+                pc = frame->pc;
+                stack_.push_back(result);
+                break;
+            }
+            default: {
+                size_t argc = BuiltinArity(op);
+                Object* builtin = LookupGlobal(frame->code, operand);
+                Object* result;
+                if (TryBuiltin(op, builtin, &result)) {
+                    stack_.resize(stack_.size() - argc);
+                    stack_.push_back(result);
+                    break;
+                }
+                stack_.insert(stack_.end() - argc, builtin);
+                frame->pc = pc;
+                Call(argc, false);
+                frame = &frames_.back();
+                pc = frame->pc;
+                break;
+            }
+        }
+    }
+}
+
+bool Machine::Call(size_t argc, bool tail) {
+    cleaner_->SafePoint();
+
+    size_t callee_index = stack_.size() - argc - 1;
+    Object* callee = stack_[callee_index];
+    if (Is<LambdaScheme>(callee)) {
+        LambdaScheme* scheme = As<LambdaScheme>(callee);
+        LambdaNode* lambda = scheme->GetCode();
+        if (lambda->ArgsCount() != argc) {
+            throw RuntimeError("Incorrect num of args");
+        }
+        Code* code = lambda->GetBytecode(cleaner_);
+        Environment* env = cleaner_->MakeEnvironment(scheme->GetClosureEnv(), lambda->LocalsCount());
+        for (size_t i = 0; i < argc; ++i) {
+            env->SetSlot(i, stack_[callee_index + 1 + i], cleaner_);
+        }
+        if (tail) {
+            // The caller's frame is done: its environment stays alive only if a
+            // closure captured it.
+            Frame& current = frames_.back();
+            stack_.resize(current.stack_base);
+            current = {code, code->Instructions(), env, current.stack_base};
+        } else {
+            if (frames_.size() >= max_depth_) {
+                throw RuntimeError("Maximum recursion depth exceeded");
+            }
+            stack_.resize(callee_index);
+            frames_.push_back({code, code->Instructions(), env, callee_index});
+        }
+        return true;
+    }
+    if (Is<BaseOpHolder>(callee)) {
+        // Builtins do not run Scheme code, so stack_ is not resized under them.
+        BaseOpHolder::Arguments arguments(stack_.data() + callee_index + 1, argc);
+        Object* result = As<BaseOpHolder>(callee)->Apply(arguments, cleaner_);
+        stack_.resize(callee_index);
+        stack_.push_back(result);
+        return false;
+    }
+    throw RuntimeError("Can't execute cell");
+}
+
+bool Machine::TryBuiltin(Opcode op, Object* builtin, Object** result) {
+    Object* a = stack_[stack_.size() - BuiltinArity(op)];
+    Object* b = stack_.back();
+    bool numbers = Is<Number>(a) && Is<Number>(b);
+    int x = GetNumber(a);
+    int y = GetNumber(b);
+    switch (op) {
+        case Opcode::ADD:
+            if (!numbers || !Is<OpHolder<Add>>(builtin)) {
+                return false;
+            }
+            *result = MakeNumber(x + y);
+            return true;
+        case Opcode::SUB:
+            if (!numbers || !Is<OpHolder<Sub>>(builtin)) {
+                return false;
+            }
+            *result = MakeNumber(x - y);
+            return true;
+        case Opcode::MUL:
+            if (!numbers || !Is<OpHolder<Mul>>(builtin)) {
+                return false;
+            }
+            *result = MakeNumber(x * y);
+            return true;
+        case Opcode::NUM_EQ:
+            if (!numbers || !Is<OpHolder<Eq>>(builtin)) {
+                return false;
+            }
+            *result = ConstructBool(x == y);
+            return true;
+        case Opcode::LESS:
+            if (!numbers || !Is<OpHolder<Less>>(builtin)) {
+                return false;
+            }
+            *result = ConstructBool(x < y);
+            return true;
+        case Opcode::GREATER:
+            if (!numbers || !Is<OpHolder<Greater>>(builtin)) {
+                return false;
+            }
+            *result = ConstructBool(x > y);
+            return true;
+        case Opcode::LESS_EQ:
+            if (!numbers || !Is<OpHolder<LessOrEq>>(builtin)) {
+                return false;
+            }
+            *result = ConstructBool(x <= y);
+            return true;
+        case Opcode::GREATER_EQ:
+            if (!numbers || !Is<OpHolder<GreaterOrEq>>(builtin)) {
+                return false;
+            }
+            *result = ConstructBool(x >= y);
+            return true;
+        case Opcode::CONS:
+            if (!IsBuiltin(builtin, &Cons)) {
+                return false;
+            }
+            *result = cleaner_->Make<Cell>(a, b);
+            return true;
+        case Opcode::CAR:
+            if (!Is<Cell>(a) || !IsBuiltin(builtin, &Car)) {
+                return false;
+            }
+            *result = As<Cell>(a)->GetFirst();
+            return true;
+        case Opcode::CDR:
+            if (!Is<Cell>(a) || !IsBuiltin(builtin, &Cdr)) {
+                return false;
+            }
+            *result = As<Cell>(a)->GetSecond();
+            return true;
+        case Opcode::IS_NULL:
+            if (!IsBuiltin(builtin, &IsNull)) {
+                return false;
+            }
+            *result = ConstructBool(a == nullptr);
+            return true;
+        case Opcode::NOT:
+            if (!IsBuiltin(builtin, &Not)) {
+                return false;
+            }
+            *result = ConstructBool(IsFalse(a));
+            return true;
+        default:
+            return false;
+    }
+}
+
+Object* Machine::LookupGlobal(Code* code, uint32_t index) {
+    Object** binding = code->GetCachedBinding(index);
+    if (binding == nullptr) {
+        binding = global_scope_->FindBinding(As<Symbol>(code->GetObject(index)));
+        if (binding == nullptr) {
+            throw NameError("No such name exists");
+        }
+        code->CacheBinding(index, binding);
+    }
+    return *binding;
+}
+
+void Machine::TraceRoots(Cleaner* cleaner) {
+    size_t first_frame = cleaner->IsMinorCollection() ? untouched_frames_ : 0;
+    size_t first_slot = first_frame == 0 ? 0 : frames_[first_frame].stack_base;
+    for (size_t i = first_slot; i < stack_.size(); ++i) {
+        cleaner->Visit(stack_[i]);
+    }
+    for (size_t i = first_frame; i < frames_.size(); ++i) {
+        cleaner->Visit(frames_[i].code);
+        cleaner->Visit(frames_[i].env);
+    }
+    // Everything reachable from here on survives as old.
+    untouched_frames_ = frames_.empty() ? 0 : frames_.size() - 1;
+}
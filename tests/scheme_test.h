@@ -5,6 +5,8 @@
 #include <error.h>
 #include <scheme.h>
 
+#include <string>
+
 class SchemeTest {
 public:
     void ExpectEq(std::string expression, const std::string& result) {
@@ -27,6 +29,16 @@ public:
         REQUIRE_THROWS_AS(interpreter_.Run(expression), NameError);
     }
 
-private:
+    // Defines (name i), which evaluates body for i, i + 1, ... below count
+    // and then returns result. A branch of if holds one expression, so the
+    // body runs in a second procedure, name-step.
+    void DefineLoop(const std::string& name, int count, const std::string& body,
+                    const std::string& result) {
+        ExpectNoError("(define (" + name + " i) (if (< i " + std::to_string(count) + ") (" +
+                      name + "-step i) " + result + "))");
+        ExpectNoError("(define (" + name + "-step i) " + body + " (" + name + " (+ i 1)))");
+    }
+
+protected:
     Interpreter interpreter_;
 };
@@ -1,5 +1,14 @@
 #include "scheme_test.h"
 
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <system_error>
+#include <mapped_file.h>
+#include <tokenizer.h>
+
 TEST_CASE_METHOD(SchemeTest, "Quote") {
     ExpectEq("(quote (1 2))", "(1 2)");
     ExpectEq("'(1 2)", "(1 2)");
@@ -11,3 +20,85 @@ TEST_CASE_METHOD(SchemeTest, "Be careful") {
     ExpectRuntimeError("('() ())");
     ExpectEq("'(())", "(())");
 }
+
+TEST_CASE_METHOD(SchemeTest, "Forms of a stream run one at a time") {
+    std::stringstream ss{"(define (sq x)\n  (* x x))\n'(1 . 2) (sq 5)\n\n'x 7"};
+    Tokenizer tokenizer{&ss};
+    std::vector<std::string> results;
+    std::string result;
+    while (interpreter_.RunNext(&tokenizer, &result)) {
+        results.push_back(result);
+    }
+    REQUIRE(results == std::vector<std::string>{"()", "(1 . 2)", "25", "x", "7"});
+
+    // Later forms see definitions made by earlier ones.
+    std::stringstream failing{"(define y 1) (car y) y '"};
+    Tokenizer rest{&failing};
+    REQUIRE(interpreter_.RunNext(&rest, &result));
+    REQUIRE_THROWS_AS(interpreter_.RunNext(&rest, &result), RuntimeError);
+    REQUIRE(interpreter_.RunNext(&rest, &result));
+    REQUIRE(result == "1");
+    REQUIRE_THROWS_AS(interpreter_.RunNext(&rest, &result), SyntaxError);
+}
+
+TEST_CASE_METHOD(SchemeTest, "A form runs before the input after it is read") {
+    std::string_view source = "(define x 1)\nx\n(+ x 1) #q";
+    std::stringstream ss{std::string(source)};
+    Tokenizer streamed{&ss};
+    Tokenizer viewed{source};
+    for (Tokenizer* tokenizer : {&streamed, &viewed}) {
+        std::string result;
+        REQUIRE(interpreter_.RunNext(tokenizer, &result));
+        REQUIRE(interpreter_.RunNext(tokenizer, &result));
+        REQUIRE(result == "1");
+        REQUIRE(interpreter_.RunNext(tokenizer, &result));
+        REQUIRE(result == "2");
+        REQUIRE_THROWS_AS(interpreter_.RunNext(tokenizer, &result), ReadError);
+    }
+}
+
+TEST_CASE_METHOD(SchemeTest, "A malformed form does not stop the forms after it") {
+    Tokenizer tokenizer{std::string_view("(define z 1)\n(if)\n(define (h . args) args)\n(+ z 1)")};
+    std::string result;
+    REQUIRE(interpreter_.RunNext(&tokenizer, &result));
+    REQUIRE_THROWS_AS(interpreter_.RunNext(&tokenizer, &result), SyntaxError);
+    try {
+        interpreter_.RunNext(&tokenizer, &result);
+        FAIL("Rest parameters are not supported");
+    } catch (const ReadError&) {
+        FAIL("The form was read whole");
+    } catch (const SyntaxError&) {
+    }
+    REQUIRE(interpreter_.RunNext(&tokenizer, &result));
+    REQUIRE(result == "2");
+}
+
+TEST_CASE_METHOD(SchemeTest, "Forms run from a mapped file") {
+    char path[] = "/tmp/scheme_test_XXXXXX";
+    int fd = mkstemp(path);
+    REQUIRE(fd >= 0);
+    close(fd);
+    std::ofstream(path) << "(define (twice x) (* 2 x))\n(twice 21)\n'(a b)\n";
+
+    std::vector<std::string> results;
+    {
+        MappedFile file(path);
+        Tokenizer tokenizer{file.View()};
+        std::string result;
+        while (interpreter_.RunNext(&tokenizer, &result)) {
+            results.push_back(result);
+        }
+    }
+    REQUIRE(results == std::vector<std::string>{"()", "42", "(a b)"});
+
+    std::ofstream(path, std::ios::trunc).flush();
+    REQUIRE(MappedFile(path).View().empty());
+    unlink(path);
+    REQUIRE_THROWS_AS(MappedFile(path), std::system_error);
+
+    // A FIFO has no size and must not map as an empty file.
+    REQUIRE(mkfifo(path, 0600) == 0);
+    REQUIRE_THROWS_AS(MappedFile(path), std::system_error);
+    unlink(path);
+    REQUIRE_THROWS_AS(MappedFile("/dev/null"), std::system_error);
+}
@@ -10,6 +10,7 @@ static constexpr uint32_t kShotsCount = 100000;
 
 TEST_CASE("Fuzzing-1") {
     Fuzzer fuzzer;
+    Cleaner cleaner;
 
     for (uint32_t i = 0; i < kShotsCount; ++i) {
         try {
@@ -20,9 +21,10 @@ TEST_CASE("Fuzzing-1") {
             std::stringstream ss{req};
             Tokenizer tokenizer{&ss};
             while (!tokenizer.IsEnd()) {
-                Read(&tokenizer);
+                Read(&tokenizer, &cleaner);
             }
         } catch (const SyntaxError&) {
         }
+        cleaner.Sweep();
     }
 }
@@ -0,0 +1,158 @@
+#include <catch2/catch_test_macros.hpp>
+#include <allocator.h>
+#include <memory_node.h>
+#include <object.h>
+#include "scheme_test.h"
+#include <memory>
+#include <thread>
+
+TEST_CASE("Marking a long list does not use the native stack") {
+    Cleaner cleaner;
+    Scope* root = cleaner.MakeScope(nullptr);
+    Object* list = nullptr;
+    for (int i = 0; i < 1'000'000; ++i) {
+        list = cleaner.Make<Cell>(MakeNumber(i), list);
+    }
+    root->AddName(cleaner.Intern("l"), list);
+    cleaner.Make<Cell>(nullptr, nullptr);
+
+    cleaner.Sweep(root);
+
+    Object* iter = list;
+    int expected = 999'999;
+    while (iter != nullptr) {
+        REQUIRE(GetNumber(As<Cell>(iter)->GetFirst()) == expected);
+        iter = As<Cell>(iter)->GetSecond();
+        --expected;
+    }
+    REQUIRE(expected == -1);
+    cleaner.DeleteAll();
+}
+
+TEST_CASE("Mark stack overflow falls back to rescanning") {
+    Cleaner cleaner(4);
+    Scope* root = cleaner.MakeScope(nullptr);
+    for (int i = 0; i < 1000; ++i) {
+        Object* inner = cleaner.Make<Cell>(MakeNumber(i), nullptr);
+        root->AddName(cleaner.Intern("x" + std::to_string(i)), cleaner.Make<Cell>(inner, nullptr));
+    }
+
+    cleaner.Sweep(root);
+
+    for (int i = 0; i < 1000; ++i) {
+        auto outer = As<Cell>(FindElemInScope(cleaner.Intern("x" + std::to_string(i)), root));
+        auto inner = As<Cell>(outer->GetFirst());
+        REQUIRE(GetNumber(inner->GetFirst()) == i);
+    }
+    cleaner.DeleteAll();
+}
+
+TEST_CASE_METHOD(SchemeTest, "Collection runs in the middle of evaluation") {
+    ExpectNoError("(define (fib n) (if (< n 2) n (+ (fib (- n 1)) (fib (- n 2)))))");
+    Cleaner* cleaner = interpreter_.GetCleaner();
+    size_t collections = cleaner->CollectionsCount();
+    ExpectEq("(fib 18)", "2584");
+    REQUIRE(cleaner->CollectionsCount() > collections);
+    REQUIRE(cleaner->HeapSize() <= Cleaner::kMinGcThreshold);
+    ExpectEq("(fib 10)", "55");
+}
+
+TEST_CASE_METHOD(SchemeTest, "Collections keep the values of waiting frames") {
+    ExpectNoError("(define (add-first cell rest) (+ (car cell) rest))");
+    ExpectNoError("(define (deep n) (if (= n 0) 0 (add-first (list n) (deep (- n 1)))))");
+    size_t collections = interpreter_.GetCleaner()->MinorCollectionsCount();
+    ExpectEq("(deep 50000)", "1250025000");
+    REQUIRE(interpreter_.GetCleaner()->MinorCollectionsCount() > collections);
+}
+
+TEST_CASE("Minor collection keeps young objects referenced from old ones") {
+    Cleaner cleaner_storage;
+    Cleaner* cleaner = &cleaner_storage;
+    Scope* root = cleaner->MakeScope(nullptr);
+    cleaner->AddRoot(root);
+    auto cell = As<Cell>(cleaner->Make<Cell>(nullptr, nullptr));
+    root->AddName(cleaner->Intern("c"), cell);
+    cleaner->SweepYoung();
+
+    cell->SetFirst(cleaner->Make<Cell>(MakeNumber(42), nullptr), cleaner);
+    cleaner->Make<Cell>(nullptr, nullptr);
+    size_t heap_size = cleaner->HeapSize();
+    size_t minor_collections = cleaner->MinorCollectionsCount();
+    cleaner->SweepYoung();
+
+    REQUIRE(cleaner->MinorCollectionsCount() == minor_collections + 1);
+    REQUIRE(cleaner->HeapSize() == heap_size - 1);
+    REQUIRE(GetNumber(As<Cell>(cell->GetFirst())->GetFirst()) == 42);
+}
+
+TEST_CASE("Interned symbols live as long as they are referenced") {
+    Cleaner cleaner;
+    Scope* root = cleaner.MakeScope(nullptr);
+    cleaner.AddRoot(root);
+    Symbol* kept = cleaner.Intern("kept");
+    root->AddName(kept, nullptr);
+    Symbol* quote = cleaner.Intern("quote");
+    cleaner.Intern("dropped-young");
+    MemoryNode* holder = cleaner.Make<Cell>(cleaner.Intern("dropped-old"), nullptr);
+    cleaner.AddRoot(holder);
+    cleaner.SweepYoung();
+    REQUIRE(cleaner.HeapSize() == 5);
+
+    cleaner.RemoveRoot(holder);
+    cleaner.Sweep();
+    REQUIRE(cleaner.HeapSize() == 3);
+    REQUIRE(cleaner.Intern("kept") == kept);
+    REQUIRE(cleaner.Intern("quote") == quote);
+    REQUIRE(cleaner.HeapSize() == 3);
+    REQUIRE(cleaner.Intern("dropped-old")->GetName() == "dropped-old");
+    REQUIRE(cleaner.HeapSize() == 4);
+}
+
+TEST_CASE("Slab allocator reuses freed slots") {
+    SlabAllocator allocator;
+    std::vector<void*> slots;
+    for (int i = 0; i < 10'000; ++i) {
+        slots.push_back(allocator.Allocate(40));
+    }
+    REQUIRE(allocator.LiveCount() == 10'000);
+
+    void* freed = slots[1234];
+    allocator.Free(freed);
+    REQUIRE(allocator.Allocate(33) == freed);
+
+    for (size_t i = 0; i < slots.size(); i += 2) {
+        allocator.Free(slots[i]);
+    }
+    size_t live = 0;
+    allocator.ForEachLive([&live](void*) { ++live; });
+    REQUIRE(live == 5'000);
+    REQUIRE(allocator.LiveCount() == 5'000);
+}
+
+TEST_CASE("Interpreters have independent heaps") {
+    auto first = std::make_unique<Interpreter>();
+    Interpreter second;
+    first->Run("(define x 1)");
+    second.Run("(define x 2)");
+    first.reset();
+    REQUIRE(second.Run("x") == "2");
+    REQUIRE(second.Run("(+ x 1)") == "3");
+}
+
+TEST_CASE("Interpreters run on separate threads") {
+    std::vector<std::string> results(4);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < results.size(); ++i) {
+        threads.emplace_back([&results, i] {
+            Interpreter interpreter;
+            interpreter.Run("(define (fib n) (if (< n 2) n (+ (fib (- n 1)) (fib (- n 2)))))");
+            results[i] = interpreter.Run("(fib 16)");
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (const auto& result : results) {
+        REQUIRE(result == "987");
+    }
+}
@@ -0,0 +1,99 @@
+#include "scheme_test.h"
+
+#include "hash_table.h"
+#include "memory_node.h"
+
+TEST_CASE_METHOD(SchemeTest, "HashTableOperations") {
+    ExpectNoError("(define h (make-hash-table))");
+    ExpectEq("(hash-table? h)", "#t");
+    ExpectEq("(hash-table? '())", "#f");
+    ExpectEq("(hash-table-count h)", "0");
+
+    ExpectNoError("(hash-table-set! h 'a 1)");
+    ExpectNoError("(hash-table-set! h 2 'two)");
+    ExpectNoError("(hash-table-set! h #t '())");
+    ExpectEq("(hash-table-ref h 'a)", "1");
+    ExpectEq("(hash-table-ref h 2)", "two");
+    ExpectEq("(hash-table-ref h #t)", "()");
+    ExpectEq("(hash-table-count h)", "3");
+
+    ExpectNoError("(hash-table-set! h 'a 10)");
+    ExpectEq("(hash-table-ref h 'a)", "10");
+    ExpectEq("(hash-table-count h)", "3");
+
+    ExpectNoError("(hash-table-delete! h 'a)");
+    ExpectNoError("(hash-table-delete! h 'missing)");
+    ExpectEq("(hash-table-count h)", "2");
+    ExpectRuntimeError("(hash-table-ref h 'a)");
+    ExpectEq("(hash-table-ref h 'a 'default)", "default");
+
+    ExpectRuntimeError("(hash-table-ref '(1 2) 1)");
+    ExpectRuntimeError("(hash-table-set! h 1)");
+}
+
+TEST_CASE_METHOD(SchemeTest, "HashTableListKeys") {
+    ExpectNoError("(define h (make-hash-table))");
+    ExpectNoError("(hash-table-set! h '(1 (2 3) . 4) 'nested)");
+    ExpectNoError("(hash-table-set! h '() 'empty)");
+    ExpectEq("(hash-table-ref h (cons 1 (cons (list 2 3) 4)))", "nested");
+    ExpectEq("(hash-table-ref h (list))", "empty");
+    ExpectEq("(hash-table-ref h '(1 (2 3) 4) 'none)", "none");
+}
+
+TEST_CASE_METHOD(SchemeTest, "HashTableCircularAndDeepKeys") {
+    ExpectNoError("(define h (make-hash-table))");
+    ExpectNoError("(define (ring) (define r (list 1 2)) (set-cdr! (cdr r) r) r)");
+    ExpectNoError("(define k (ring))");
+    ExpectNoError("(hash-table-set! h k 'ring)");
+    ExpectEq("(hash-table-ref h k)", "ring");
+    ExpectEq("(hash-table-ref h (ring))", "ring");
+    ExpectEq("(hash-table-ref h (list 1 2 1 2) 'none)", "none");
+
+    ExpectNoError("(define (nest n acc) (if (= n 0) acc (nest (- n 1) (list acc))))");
+    ExpectNoError("(hash-table-set! h (nest 1000000 1) 'deep)");
+    ExpectEq("(hash-table-ref h (nest 1000000 1))", "deep");
+    ExpectEq("(hash-table-ref h (nest 1000000 2) 'none)", "none");
+}
+
+TEST_CASE_METHOD(SchemeTest, "HashTableWalk") {
+    ExpectNoError("(define h (make-hash-table))");
+    ExpectNoError("(hash-table-set! h 1 10)");
+    ExpectNoError("(hash-table-set! h 2 20)");
+    ExpectNoError("(hash-table-set! h 3 30)");
+    ExpectNoError("(define sum 0)");
+    ExpectNoError("(hash-table-walk h (lambda (k v) (set! sum (+ sum k v))))");
+    ExpectEq("sum", "66");
+}
+
+TEST_CASE_METHOD(SchemeTest, "HashTableGrowsAndSurvivesCollections") {
+    ExpectNoError("(define h (make-hash-table))");
+    DefineLoop("fill", 100000, "(hash-table-set! h (list i) (list i i))", "h");
+    ExpectNoError("(fill 0)");
+    REQUIRE(interpreter_.GetCleaner()->MinorCollectionsCount() > 0);
+    ExpectEq("(hash-table-count h)", "100000");
+    ExpectEq("(hash-table-ref h '(0))", "(0 0)");
+    ExpectEq("(hash-table-ref h '(99999))", "(99999 99999)");
+}
+
+TEST_CASE("HashTableEraseKeepsProbeSequences") {
+    Cleaner cleaner;
+    auto table = cleaner.Make<HashTable>();
+    const int count = 200'000;
+    for (int i = 0; i < count; ++i) {
+        table->Set(MakeNumber(i), MakeNumber(-i), &cleaner);
+    }
+    for (int i = 0; i < count; i += 2) {
+        REQUIRE(table->Erase(MakeNumber(i)));
+    }
+    REQUIRE(!table->Erase(MakeNumber(0)));
+    REQUIRE(table->Count() == count / 2);
+    for (int i = 0; i < count; ++i) {
+        Object** value = table->Find(MakeNumber(i));
+        if (i % 2 == 0) {
+            REQUIRE(value == nullptr);
+        } else {
+            REQUIRE(value != nullptr);
+            REQUIRE(GetNumber(*value) == -i);
+        }
+    }
+}
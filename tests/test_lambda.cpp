@@ -12,3 +12,101 @@ TEST_CASE_METHOD(SchemeTest, "LambdaSyntax") {
     ExpectSyntaxError("(lambda x)");
     ExpectSyntaxError("(lambda (x))");
 }
+
+TEST_CASE_METHOD(SchemeTest, "LambdaClosures") {
+    ExpectNoError("(define (make-adder n) (lambda (x) (+ x n)))");
+    ExpectNoError("(define add-2 (make-adder 2))");
+    ExpectNoError("(define add-5 (make-adder 5))");
+    ExpectEq("(add-2 1)", "3");
+    ExpectEq("(add-5 1)", "6");
+
+    ExpectNoError("(define (make-counter) (define count 0) (lambda () (set! count (+ count 1)) count))");
+    ExpectNoError("(define counter (make-counter))");
+    ExpectEq("(counter)", "1");
+    ExpectEq("(counter)", "2");
+    ExpectEq("((make-counter))", "1");
+}
+
+TEST_CASE_METHOD(SchemeTest, "LambdaLexicalScope") {
+    ExpectNoError("(define x 1)");
+    ExpectNoError("(define (get-x) x)");
+    ExpectNoError("(define (shadow x) (get-x))");
+    ExpectEq("(shadow 2)", "1");
+
+    ExpectNoError("(define (f list) (car list))");
+    ExpectEq("(f '(7 8))", "7");
+    ExpectNoError("(define (apply-op op a b) (op a b))");
+    ExpectEq("(apply-op + 3 4)", "7");
+    ExpectEq("((((lambda (a) (lambda (b) (lambda (c) (+ a b c)))) 1) 2) 3)", "6");
+}
+
+TEST_CASE_METHOD(SchemeTest, "LambdaInternalDefines") {
+    ExpectNoError("(define (f a) (define b (* a 2)) (define (g c) (+ b c)) (g a))");
+    ExpectEq("(f 3)", "9");
+    ExpectEq("(f 5)", "15");
+}
+
+TEST_CASE_METHOD(SchemeTest, "LambdaBodyIsCheckedOnDefinition") {
+    ExpectSyntaxError("(define (f) (if))");
+    ExpectNoError("(define (g) (undefined-function))");
+    ExpectNameError("(g)");
+    ExpectEq("((lambda (if) (if 1)) (lambda (x) (+ x 1)))", "2");
+}
+
+TEST_CASE_METHOD(SchemeTest, "RedefinedBuiltinsAreCalled") {
+    ExpectNoError("(define (first-of p) (car p))");
+    ExpectNoError("(define (add a b) (+ a b))");
+    ExpectEq("(first-of '(1 2))", "1");
+    ExpectEq("(add 1 2)", "3");
+    ExpectNoError("(define (car p) 42)");
+    ExpectNoError("(set! + -)");
+    ExpectEq("(first-of '(1 2))", "42");
+    ExpectEq("(add 1 2)", "-1");
+}
+
+TEST_CASE_METHOD(SchemeTest, "DeepRecursionDoesNotUseNativeStack") {
+    ExpectNoError("(define (count n) (if (= n 0) 0 (+ 1 (count (- n 1)))))");
+    ExpectEq("(count 100000)", "100000");
+}
+
+TEST_CASE_METHOD(SchemeTest, "TailCallsRunInConstantSpace") {
+    ExpectNoError("(define (loop n) (if (= n 0) 'done (loop (- n 1))))");
+    ExpectEq("(loop 100000)", "done");
+
+    ExpectNoError("(define (my-even? n) (or (= n 0) (my-odd? (- n 1))))");
+    ExpectNoError("(define (my-odd? n) (and (not (= n 0)) (my-even? (- n 1))))");
+    ExpectEq("(my-even? 100001)", "#f");
+    ExpectEq("(my-odd? 100001)", "#t");
+
+    ExpectNoError("(define total 0)");
+    DefineLoop("sum", 10001, "(define next (+ total i)) (set! total next)", "total");
+    ExpectEq("(sum 0)", "50005000");
+}
+
+TEST_CASE("RecursionDepthIsLimited") {
+    Interpreter interpreter(1000);
+    interpreter.Run("(define (count n) (if (= n 0) 0 (+ 1 (count (- n 1)))))");
+    REQUIRE(interpreter.Run("(count 900)") == "900");
+    REQUIRE_THROWS_AS(interpreter.Run("(count 1000)"), RuntimeError);
+    REQUIRE(interpreter.Run("(count 10)") == "10");
+
+    interpreter.Run("(define (loop n) (if (= n 0) 0 (loop (- n 1))))");
+    REQUIRE(interpreter.Run("(loop 100000)") == "0");
+}
+
+TEST_CASE_METHOD(SchemeTest, "LambdaWithManyLocals") {
+    // More locals than a frame holds inline.
+    std::string params;
+    std::string sum = "(+";
+    for (int i = 0; i < 40; ++i) {
+        params += " x" + std::to_string(i);
+        sum += " x" + std::to_string(i);
+    }
+    sum += ")";
+    ExpectNoError("(define (many" + params + ") (lambda () " + sum + "))");
+    std::string call = "((many";
+    for (int i = 0; i < 40; ++i) {
+        call += " " + std::to_string(i);
+    }
+    ExpectEq(call + "))", "780");
+}
@@ -76,3 +76,22 @@ TEST_CASE_METHOD(SchemeTest, "ListOperations") {
     ExpectRuntimeError("(list-ref '(1 2 3) 10)");
     ExpectRuntimeError("(list-tail '(1 2 3) 10)");
 }
+
+TEST_CASE_METHOD(SchemeTest, "SetCarAndSetCdr") {
+    ExpectNoError("(define x '(1 . 2))");
+    ExpectNoError("(set-car! x 5)");
+    ExpectEq("x", "(5 . 2)");
+    ExpectNoError("(set-cdr! x '(3))");
+    ExpectEq("x", "(5 3)");
+    ExpectRuntimeError("(set-car! 1 2)");
+}
+
+TEST_CASE_METHOD(SchemeTest, "TailsShareStructure") {
+    ExpectNoError("(define x '(1 2 3 4))");
+    ExpectNoError("(set-car! (cdr x) 5)");
+    ExpectEq("x", "(1 5 3 4)");
+    ExpectNoError("(set-cdr! (list-tail x 2) '(6))");
+    ExpectEq("x", "(1 5 3 6)");
+    ExpectEq("(list-tail '(1 2 . 3) 2)", "3");
+    ExpectRuntimeError("(list-tail '(1 2 . 3) 3)");
+}
@@ -6,11 +6,13 @@
 #include <parser.h>
 #include <random>
 
+static Cleaner cleaner;
+
 auto ReadFull(const std::string& str) {
     std::stringstream ss{str};
     Tokenizer tokenizer{&ss};
 
-    auto obj = Read(&tokenizer);
+    auto obj = Read(&tokenizer, &cleaner);
     REQUIRE(tokenizer.IsEnd());
     return obj;
 }
@@ -18,11 +20,11 @@ auto ReadFull(const std::string& str) {
 TEST_CASE("Read number") {
     auto node = ReadFull("5");
     REQUIRE(Is<Number>(node));
-    REQUIRE(As<Number>(node)->GetValue() == 5);
+    REQUIRE(GetNumber(node) == 5);
 
     node = ReadFull("-5");
     REQUIRE(Is<Number>(node));
-    REQUIRE(As<Number>(node)->GetValue() == -5);
+    REQUIRE(GetNumber(node) == -5);
 }
 
 std::string RandomSymbol(std::default_random_engine* rng) {
@@ -64,11 +66,11 @@ TEST_CASE("Lists") {
 
         auto first = As<Cell>(pair)->GetFirst();
         REQUIRE(Is<Number>(first));
-        REQUIRE(As<Number>(first)->GetValue() == 1);
+        REQUIRE(GetNumber(first) == 1);
 
         auto second = As<Cell>(pair)->GetSecond();
         REQUIRE(Is<Number>(second));
-        REQUIRE(As<Number>(second)->GetValue() == 2);
+        REQUIRE(GetNumber(second) == 2);
     }
 
     SECTION("Simple list") {
@@ -77,12 +79,12 @@ TEST_CASE("Lists") {
 
         auto first = As<Cell>(list)->GetFirst();
         REQUIRE(Is<Number>(first));
-        REQUIRE(As<Number>(first)->GetValue() == 1);
+        REQUIRE(GetNumber(first) == 1);
 
         list = As<Cell>(list)->GetSecond();
         auto second = As<Cell>(list)->GetFirst();
         REQUIRE(Is<Number>(second));
-        REQUIRE(As<Number>(second)->GetValue() == 2);
+        REQUIRE(GetNumber(second) == 2);
 
         REQUIRE(!As<Cell>(list)->GetSecond());
     }
@@ -98,12 +100,12 @@ TEST_CASE("Lists") {
         list = As<Cell>(list)->GetSecond();
         auto second = As<Cell>(list)->GetFirst();
         REQUIRE(Is<Number>(second));
-        REQUIRE(As<Number>(second)->GetValue() == 1);
+        REQUIRE(GetNumber(second) == 1);
 
         list = As<Cell>(list)->GetSecond();
         second = As<Cell>(list)->GetFirst();
         REQUIRE(Is<Number>(second));
-        REQUIRE(As<Number>(second)->GetValue() == 2);
+        REQUIRE(GetNumber(second) == 2);
 
         REQUIRE(!As<Cell>(list)->GetSecond());
     }
@@ -115,16 +117,16 @@ TEST_CASE("Lists") {
 
         auto first = As<Cell>(list)->GetFirst();
         REQUIRE(Is<Number>(first));
-        REQUIRE(As<Number>(first)->GetValue() == 1);
+        REQUIRE(GetNumber(first) == 1);
 
         list = As<Cell>(list)->GetSecond();
         auto second = As<Cell>(list)->GetFirst();
         REQUIRE(Is<Number>(second));
-        REQUIRE(As<Number>(second)->GetValue() == 2);
+        REQUIRE(GetNumber(second) == 2);
 
         auto last = As<Cell>(list)->GetSecond();
         REQUIRE(Is<Number>(last));
-        REQUIRE(As<Number>(last)->GetValue() == 3);
+        REQUIRE(GetNumber(last) == 3);
     }
 
     SECTION("Complex lists") {
@@ -155,3 +157,29 @@ TEST_CASE("Invalid") {
     REQUIRE_THROWS_AS(ReadFull("(1 . )"), SyntaxError);
     REQUIRE_THROWS_AS(ReadFull("(1 . 2 3)"), SyntaxError);
 }
+
+TEST_CASE("Input is not limited by stack depth") {
+    SECTION("Long list") {
+        std::string str = "(";
+        for (int i = 0; i < 200000; ++i) {
+            str += std::to_string(i) + " ";
+        }
+        auto list = ReadFull(str + ". -1)");
+        for (int i = 0; i < 200000; ++i) {
+            REQUIRE(GetNumber(As<Cell>(list)->GetFirst()) == i);
+            list = As<Cell>(list)->GetSecond();
+        }
+        REQUIRE(GetNumber(list) == -1);
+    }
+
+    SECTION("Deep nesting") {
+        const int depth = 1000000;
+        auto list = ReadFull(std::string(depth, '(') + "1" + std::string(depth, ')'));
+        for (int i = 0; i < depth; ++i) {
+            REQUIRE(!As<Cell>(list)->GetSecond());
+            list = As<Cell>(list)->GetFirst();
+        }
+        REQUIRE(GetNumber(list) == 1);
+        REQUIRE_THROWS_AS(ReadFull(std::string(depth, '(')), SyntaxError);
+    }
+}
@@ -15,4 +15,25 @@ TEST_CASE_METHOD(SchemeTest, "SetInvalidSyntax") {
     ExpectSyntaxError("(set!)");
     ExpectSyntaxError("(set! 1)");
     ExpectSyntaxError("(set! x 1 2)");
-}
\ No newline at end of file
+}
+
+TEST_CASE_METHOD(SchemeTest, "DefinitionsPersistBetweenRuns") {
+    ExpectNoError("(define x 5)");
+    ExpectEq("x", "5");
+    ExpectNoError("(define (inc y) (+ y 1))");
+    ExpectEq("(inc x)", "6");
+    ExpectNoError("(set! x 10)");
+    ExpectEq("(inc x)", "11");
+}
+
+TEST_CASE_METHOD(SchemeTest, "GlobalsAreReadAfterRedefinition") {
+    ExpectNoError("(define (get-x) x)");
+    ExpectNameError("(get-x)");
+    ExpectNoError("(define x 1)");
+    ExpectEq("(get-x)", "1");
+    ExpectNoError("(define x 2)");
+    ExpectEq("(get-x)", "2");
+
+    DefineLoop("bump", 10, "(set! x (+ x 1))", "x");
+    ExpectEq("(bump 0)", "12");
+}
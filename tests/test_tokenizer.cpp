@@ -1,9 +1,13 @@
 #include <catch2/catch_test_macros.hpp>
 
 #include <error.h>
+#include <fd_stream.h>
 #include <tokenizer.h>
 
+#include <unistd.h>
 #include <sstream>
+#include <string>
+#include <vector>
 
 TEST_CASE("Tokenizer works on simple case") {
     std::stringstream ss{"4+)'."};
@@ -116,6 +120,17 @@ TEST_CASE("Spaces are handled correctly") {
         tokenizer.Next();
         REQUIRE(tokenizer.IsEnd());
     }
+
+    SECTION("Tabs and carriage returns") {
+        std::stringstream ss{"\t4\r\n+\t"};
+        Tokenizer tokenizer{&ss};
+
+        REQUIRE(tokenizer.GetToken() == Token{ConstantToken{4}});
+        tokenizer.Next();
+        REQUIRE(tokenizer.GetToken() == Token{SymbolToken{"+"}});
+        tokenizer.Next();
+        REQUIRE(tokenizer.IsEnd());
+    }
 }
 
 TEST_CASE("Literal strings are handled correctly") {
@@ -153,3 +168,75 @@ TEST_CASE("Empty string handled correctly") {
 
     REQUIRE(tokenizer.IsEnd());
 }
+
+TEST_CASE("Tokenizer over a string view") {
+    std::string source = "(define (f x) '(#t . -12))\t\r\n";
+    Tokenizer tokenizer{std::string_view(source)};
+    std::vector<Token> tokens;
+    for (; !tokenizer.IsEnd(); tokenizer.Next()) {
+        tokens.push_back(tokenizer.GetToken());
+    }
+    std::vector<Token> expected = {
+        BracketToken::OPEN, SymbolToken{"define"}, BracketToken::OPEN, SymbolToken{"f"},
+        SymbolToken{"x"}, BracketToken::CLOSE, QuoteToken{}, BracketToken::OPEN,
+        SymbolToken{"#t"}, DotToken{}, ConstantToken{-12}, BracketToken::CLOSE,
+        BracketToken::CLOSE};
+    REQUIRE(tokens == expected);
+    // Names are views into the source.
+    REQUIRE(std::get<SymbolToken>(tokens[1]).name.data() == source.data() + 1);
+}
+
+TEST_CASE("Numbers out of range") {
+    Tokenizer tokenizer{std::string_view("+2147483647")};
+    REQUIRE(tokenizer.GetToken() == Token{ConstantToken{2147483647}});
+    REQUIRE_THROWS_AS(Tokenizer{std::string_view("99999999999")}, SyntaxError);
+}
+
+TEST_CASE("Hash starts only booleans") {
+    // A leading # takes one t or f, so #tx is #t followed by x. Inside a
+    // symbol it is an ordinary character.
+    Tokenizer tokenizer{std::string_view("#tx #foo a#b")};
+    std::vector<Token> tokens;
+    for (; !tokenizer.IsEnd(); tokenizer.Next()) {
+        tokens.push_back(tokenizer.GetToken());
+    }
+    std::vector<Token> expected{SymbolToken{"#t"}, SymbolToken{"x"}, SymbolToken{"#f"},
+                                SymbolToken{"oo"}, SymbolToken{"a#b"}};
+    REQUIRE(tokens == expected);
+
+    REQUIRE_THROWS_AS(Tokenizer{std::string_view("#x")}, SyntaxError);
+    REQUIRE_THROWS_AS(Tokenizer{std::string_view("#")}, SyntaxError);
+}
+
+static void RequireSameTokens(Tokenizer* stream, std::string_view source) {
+    Tokenizer view{source};
+    for (; !view.IsEnd(); view.Next(), stream->Next()) {
+        REQUIRE(!stream->IsEnd());
+        REQUIRE(stream->GetToken() == view.GetToken());
+    }
+    REQUIRE(stream->IsEnd());
+}
+
+TEST_CASE("Tokens span stream chunks") {
+    std::string source;
+    for (int i = 0; source.size() < 3 * Tokenizer::kChunkSize; ++i) {
+        source += "(symbol-" + std::to_string(i) + " " + std::to_string(i) + " '#t . -1)\n";
+    }
+    std::stringstream ss{source};
+    Tokenizer tokenizer{&ss};
+    RequireSameTokens(&tokenizer, source);
+}
+
+TEST_CASE("Tokenizer reads a file descriptor") {
+    std::string source = "(define (long-name-of-a-function x) (+ x 12345))\n'(a . b)";
+    int fds[2];
+    REQUIRE(pipe(fds) == 0);
+    REQUIRE(write(fds[1], source.data(), source.size()) == static_cast<ssize_t>(source.size()));
+    close(fds[1]);
+    // A tiny chunk puts boundaries inside tokens.
+    FdStreamBuf buffer(fds[0], 3);
+    std::istream in(&buffer);
+    Tokenizer tokenizer{&in};
+    RequireSameTokens(&tokenizer, source);
+    close(fds[0]);
+}
@@ -0,0 +1,48 @@
+#include "scheme_test.h"
+
+TEST_CASE_METHOD(SchemeTest, "VectorConstruction") {
+    ExpectEq("(vector)", "#()");
+    ExpectEq("(vector 1 '(2 3) #t)", "#(1 (2 3) #t)");
+    ExpectEq("(make-vector 3 0)", "#(0 0 0)");
+    ExpectEq("(vector-length (make-vector 5))", "5");
+    ExpectEq("(vector? (vector 1))", "#t");
+    ExpectEq("(vector? '(1))", "#f");
+
+    ExpectRuntimeError("(make-vector -1)");
+    ExpectRuntimeError("(make-vector 'a)");
+    ExpectRuntimeError("(vector-length '(1 2))");
+}
+
+TEST_CASE_METHOD(SchemeTest, "VectorAccess") {
+    ExpectNoError("(define v (vector 1 2 3))");
+    ExpectEq("(vector-ref v 0)", "1");
+    ExpectEq("(vector-ref v 2)", "3");
+    ExpectNoError("(vector-set! v 1 'x)");
+    ExpectEq("v", "#(1 x 3)");
+    ExpectNoError("(vector-fill! v 7)");
+    ExpectEq("v", "#(7 7 7)");
+
+    ExpectRuntimeError("(vector-ref v 3)");
+    ExpectRuntimeError("(vector-ref v -1)");
+    ExpectRuntimeError("(vector-set! v 3 0)");
+    ExpectRuntimeError("(vector-ref '(1 2) 0)");
+}
+
+TEST_CASE_METHOD(SchemeTest, "VectorListConversion") {
+    ExpectEq("(vector->list (vector 1 2 3))", "(1 2 3)");
+    ExpectEq("(vector->list (vector))", "()");
+    ExpectEq("(list->vector '(1 2 3))", "#(1 2 3)");
+    ExpectEq("(list->vector '())", "#()");
+    ExpectRuntimeError("(list->vector '(1 . 2))");
+}
+
+TEST_CASE_METHOD(SchemeTest, "VectorElementsSurviveCollections") {
+    ExpectNoError("(define v (make-vector 1000))");
+    DefineLoop("fill", 1000, "(vector-set! v i (list i i))", "v");
+    ExpectNoError("(fill 0)");
+    DefineLoop("garbage", 100000, "(list i i i)", "0");
+    ExpectNoError("(garbage 0)");
+    REQUIRE(interpreter_.GetCleaner()->MinorCollectionsCount() > 0);
+    ExpectEq("(vector-ref v 0)", "(0 0)");
+    ExpectEq("(vector-ref v 999)", "(999 999)");
+}